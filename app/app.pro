@@ -1,4 +1,5 @@
 QT -= gui
+QT += network
 
 CONFIG += c++17
 CONFIG += console
@@ -12,22 +13,46 @@ INCLUDEPATH += $$APPDIR
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Build with "qmake CONFIG+=profiling" to record the PROFILE_ZONE() timers and
+# write them to trace.json on exit.
+profiling: DEFINES += ENABLE_PROFILING
+
 SOURCES += \
         apputils.cpp \
         cliplaygroundapplication.cpp \
+        batchsizer.cpp \
+        clockpacer.cpp \
+        emulationthread.cpp \
+        headlessrunner.cpp \
+        hostcounters.cpp \
+        performancemonitor.cpp \
+        statisticsexporter.cpp \
+        utilities/Profiling.cpp \
         utilities/StringConversions.cpp \
+        emulator/breakpointcondition.cpp \
+        emulator/breakpoints.cpp \
         emulator/bus.cpp \
         emulator/computer.cpp \
+        emulator/cpubackend.cpp \
         emulator/disassembly.cpp \
         emulator/disassemblyview.cpp \
+        emulator/flightrecorder.cpp \
         emulator/ibusdevice.cpp \
         emulator/instructionexecutor.cpp \
+        emulator/instructionprofile.cpp \
+        emulator/lockstepchecker.cpp \
+        emulator/machinesnapshot.cpp \
+        emulator/memoryheatmap.cpp \
         emulator/memorypage.cpp \
         emulator/olc6502.cpp \
         emulator/pageview.cpp \
         emulator/rambusdevice.cpp \
         emulator/rambusdeviceview.cpp \
+        emulator/sessionstatistics.cpp \
+        emulator/statehash.cpp \
         emulator/registerview.cpp \
+        emulator/usagemonitor.cpp \
+        emulator/writeprovenance.cpp \
         ui/components/directorybrowser.cpp \
         ui/components/inputnumber.cpp \
         ui/components/list.cpp \
@@ -45,21 +70,42 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 HEADERS += \
     apputils.hpp \
     cliplaygroundapplication.h \
+    batchsizer.hpp \
+    clockpacer.hpp \
+    emulationthread.hpp \
+    headlessrunner.hpp \
+    hostcounters.hpp \
+    performancemonitor.hpp \
+    statisticsexporter.hpp \
+    utilities/Profiling.hpp \
+    utilities/SpscQueue.hpp \
     utilities/StringConversions.hpp \
+    emulator/breakpointcondition.hpp \
+    emulator/breakpoints.hpp \
     emulator/bus.hpp \
     emulator/computer.hpp \
+    emulator/cpubackend.hpp \
     emulator/disassembly.hpp \
     emulator/disassemblyview.hpp \
     emulator/flags.hpp \
+    emulator/flightrecorder.hpp \
     emulator/ibusdevice.hpp \
     emulator/instructionexecutor.hpp \
+    emulator/instructionprofile.hpp \
+    emulator/lockstepchecker.hpp \
+    emulator/machinesnapshot.hpp \
+    emulator/memoryheatmap.hpp \
     emulator/memorypage.hpp \
     emulator/olc6502.hpp \
     emulator/pageview.hpp \
     emulator/rambusdevice.hpp \
     emulator/rambusdeviceview.hpp \
+    emulator/sessionstatistics.hpp \
+    emulator/statehash.hpp \
     emulator/registers.hpp \
     emulator/registerview.hpp \
+    emulator/usagemonitor.hpp \
+    emulator/writeprovenance.hpp \
     ui/components/directorybrowser.hpp \
     ui/components/inputnumber.hpp \
     ui/components/list.hpp \
@@ -0,0 +1,24 @@
+#include "batchsizer.hpp"
+#include <algorithm>
+
+
+void BatchSizer::ran(uint64_t cycles, clockType::duration elapsed)
+{
+    const double elapsed_us = std::chrono::duration<double, std::micro>( elapsed ).count();
+
+    // Too short to measure anything worthwhile
+    if ( (cycles == 0) || (elapsed_us < 1.0) )
+        return;
+
+    const double cycles_per_us = cycles / elapsed_us;
+
+    // Follow changes quickly, but don't jump at one odd batch
+    if ( _cycles_per_us == 0.0 )
+        _cycles_per_us = cycles_per_us;
+    else
+        _cycles_per_us += (cycles_per_us - _cycles_per_us) / 4.0;
+
+    const double target_us = std::chrono::duration<double, std::micro>( _target ).count();
+
+    _cycles = static_cast<uint32_t>( std::clamp( _cycles_per_us * target_us, double(MinimumCycles), double(MaximumCycles) ) );
+}
@@ -0,0 +1,46 @@
+#ifndef BATCHSIZER_HPP
+#define BATCHSIZER_HPP
+
+#include <chrono>
+#include <cstdint>
+
+
+/** Picks how many cycles to run at a time so that each batch takes about as long as wanted.
+ *
+ *  How fast the CPU runs on the host depends on the program and on what is
+ *  switched on (breakpoints, watchpoints, the heatmap...), so a fixed number
+ *  of cycles can take anything from microseconds to many milliseconds.
+ *  Instead, the time each batch took is measured (only at its ends, never
+ *  inside it) and a running average of the cycles per microsecond decides
+ *  the size of the next.
+ */
+class BatchSizer
+{
+public:
+    using clockType = std::chrono::steady_clock;
+
+    static constexpr uint32_t InitialCycles = 10000;
+    static constexpr uint32_t MinimumCycles = 100;
+    static constexpr uint32_t MaximumCycles = 4'000'000;
+
+    /// @param duration How long each batch should take
+    void setTarget(clockType::duration duration) { _target = duration; }
+    clockType::duration target() const { return _target; }
+
+    /// The number of cycles for the next batch to take @c target()
+    uint32_t cycles() const { return _cycles; }
+
+    /** Counts a batch, adjusting the size of the next.
+     *
+     *  @param cycles  The number of cycles it ran.  Batches cut short by a breakpoint still count.
+     *  @param elapsed How long it took
+     */
+    void ran(uint64_t cycles, clockType::duration elapsed);
+
+protected:
+    clockType::duration _target{ std::chrono::milliseconds(4) };
+    double              _cycles_per_us = 0.0; ///< The running average, or 0 before the first batch
+    uint32_t            _cycles = InitialCycles;
+};
+
+#endif // BATCHSIZER_HPP
@@ -2,12 +2,18 @@
 #include "ftxui/dom/node.hpp"
 #include "ftxui/dom/elements.hpp"
 #include "ftxui/component/loop.hpp"
+#include "utilities/StringConversions.hpp"
+#include "utilities/Profiling.hpp"
 #include <QTimer>
+#include <QCommandLineParser>
 #include <cstdlib>
+#include <iostream>
 #include <functional>
 #include <QBuffer>
 #include <QByteArray>
 #include <chrono>
+#include <cmath>
+#include <thread>
 
 using namespace std;
 using namespace ftxui;
@@ -43,32 +49,97 @@ CLIPlaygroundApplication::CLIPlaygroundApplication(int &argc, char *argv[])
     _ui_update_rates_dropdown_display_strings.reserve( _ui_update_rates.size() );
     for (const auto &[key, value] : _ui_update_rates )
         _ui_update_rates_dropdown_display_strings.push_back( key );
+    _clock_rates_dropdown_display_strings.reserve( _clock_rates.size() );
+    for (const auto &[key, value] : _clock_rates )
+        _clock_rates_dropdown_display_strings.push_back( key );
+    _speeds_dropdown_display_strings.reserve( _speeds.size() );
+    for (const auto &[key, value] : _speeds )
+        _speeds_dropdown_display_strings.push_back( key );
 
     setApplicationName("cli-6502-playground");
     setApplicationVersion("1.0.0");
+    parseCommandLine();
     _Instance = this;
     computer.cpu()->connect(computer.cpu(), &olc6502::pcChanged,
                             [this](uint16_t new_value)
                             {
                                 this->_program_counter = static_cast<int>(new_value);
                             });
-    computer.ram()->connect(computer.ram(), &RamBusDevice::memoryChanged,
-                            std::bind( &CLIPlaygroundApplication::memoryChanged, this, std::placeholders::_1, std::placeholders::_2 ));
     input_nmi_option.on_change = [this]()
     {
-        computer.ram()->write( olc6502::NMIAddress    , LowByteOf( *input_nmi_option.data ) );
-        computer.ram()->write( olc6502::NMIAddress + 1, HighByteOf( *input_nmi_option.data ) );
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.ram()->edit( olc6502::NMIAddress    , LowByteOf( *input_nmi_option.data ) );
+        computer.ram()->edit( olc6502::NMIAddress + 1, HighByteOf( *input_nmi_option.data ) );
     };
     input_reset_option.on_change = [this]()
     {
-        computer.ram()->write( olc6502::ResetJumpStartAddress    , LowByteOf( *input_reset_option.data ) );
-        computer.ram()->write( olc6502::ResetJumpStartAddress + 1, HighByteOf( *input_reset_option.data ) );
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.ram()->edit( olc6502::ResetJumpStartAddress    , LowByteOf( *input_reset_option.data ) );
+        computer.ram()->edit( olc6502::ResetJumpStartAddress + 1, HighByteOf( *input_reset_option.data ) );
     };
     input_irq_option.on_change = [this]()
     {
-        computer.ram()->write( olc6502::IRQAddress    , LowByteOf( *input_irq_option.data ) );
-        computer.ram()->write( olc6502::IRQAddress + 1, HighByteOf( *input_irq_option.data ) );
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.ram()->edit( olc6502::IRQAddress    , LowByteOf( *input_irq_option.data ) );
+        computer.ram()->edit( olc6502::IRQAddress + 1, HighByteOf( *input_irq_option.data ) );
+    };
+    _memorypage_option.on_edit = [this](IBusDevice::addressType address, uint8_t value)
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.ram()->edit( address, value );
+    };
+    _memorypage_option.heatmap = computer.heatmap();
+    _memorypage_option.on_heatmap_overlay_change = [this]()
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        // Only pay for the counting while somebody is looking at it
+        computer.setHeatmapEnabled( _memorypage_option.heatmap_overlay() != MemoryPageOption::NoOverlay );
+    };
+    _memorypage_option.on_heatmap_export = [this]()
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.exportHeatmap( QStringLiteral("heatmap.csv") );
+    };
+    _memorypage_option.watchpoints = &computer.breakpoints();
+    _memorypage_option.on_toggle_watchpoint = [this](IBusDevice::addressType address, Breakpoints::Kind kind)
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.toggleBreakpoint( kind, address );
+    };
+    _memorypage_option.on_write_provenance_toggle = [this]()
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.setWriteProvenanceEnabled( !computer.writeProvenanceEnabled() );
+        _memorypage_option.write_provenance = computer.writeProvenanceEnabled() ? computer.writeProvenance() : nullptr;
+    };
+    _memorypage_option.on_write_provenance_export = [this]()
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.exportWriteProvenance( QStringLiteral("writes.csv") );
+    };
+    _disassembly_option.breakpoints = &computer.breakpoints();
+    _disassembly_option.on_toggle_breakpoint = [this](olc6502::addressType address)
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.toggleBreakpoint( Breakpoints::Execute, address );
+    };
+    _disassembly_option.on_edit_condition = std::bind( &CLIPlaygroundApplication::onEditCondition, this, std::placeholders::_1 );
+    _disassembly_option.has_condition = [this](olc6502::addressType address)
+    {
+        return computer.breakpointCondition( address ) != nullptr;
     };
+    *run_cycles_option.data = 1000;
+    *run_cycles_option.base = Base::Decimal;
     load_file_option.finished = std::bind( &CLIPlaygroundApplication::onLoadFileFinished, this, std::placeholders::_1 );
     if (const char *unix_home_env = std::getenv("HOME"); unix_home_env)
         load_file_option.curent_directory() = filesystem::path(unix_home_env);
@@ -87,6 +158,34 @@ CLIPlaygroundApplication::~CLIPlaygroundApplication()
     _Instance = nullptr;
 }
 
+void CLIPlaygroundApplication::parseCommandLine()
+{
+    QCommandLineParser parser;
+    QCommandLineOption stats_port_option( "stats-port", "Publish statistics on localhost <port>.", "port" );
+
+    parser.setApplicationDescription( "A 6502 emulator and playground for the terminal." );
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOption( stats_port_option );
+    parser.process( *this );
+
+    if ( parser.isSet( stats_port_option ) )
+    {
+        bool valid_port = false;
+        const quint16 port = parser.value( stats_port_option ).toUShort( &valid_port );
+
+        computer.setStatisticsEnabled( true );
+        _statistics_exporter = std::make_unique<StatisticsExporter>( computer.statistics(), port );
+        if ( !valid_port || !_statistics_exporter->startListening() )
+        {
+            // Carry on without it, the terminal is about to be taken over anyway
+            std::cerr << "Unable to listen on port " << parser.value( stats_port_option ).toStdString() << "\n";
+            _statistics_exporter.reset();
+            computer.setStatisticsEnabled( false );
+        }
+    }
+}
+
 void CLIPlaygroundApplication::Update()
 {
     if (_Instance)
@@ -95,12 +194,7 @@ void CLIPlaygroundApplication::Update()
 
 void CLIPlaygroundApplication::setup_ui()
 {
-    *input_nmi_option.data = MakeWord( computer.ram()->read( olc6502::NMIAddress, false ),
-                                        computer.ram()->read( olc6502::NMIAddress + 1, false ) );
-    *input_reset_option.data = MakeWord( computer.ram()->read( olc6502::ResetJumpStartAddress, false ),
-                                          computer.ram()->read( olc6502::ResetJumpStartAddress + 1, false ) );
-    *input_irq_option.data = MakeWord( computer.ram()->read( olc6502::IRQAddress, false ),
-                                        computer.ram()->read( olc6502::IRQAddress + 1, false ) );
+    updateSystemVectors( computer.ram()->memory() );
 
     ram_view->setModel( computer.ram() );
     ram_view->setPage(0);
@@ -111,11 +205,18 @@ void CLIPlaygroundApplication::setup_ui()
     register_view_component = register_view->component();
     step_button = Button("Step", std::bind(&CLIPlaygroundApplication::onStepButtonPressed, this), ButtonOption::Border());
     next_instruction_button = Button("Next Instruction", std::bind(&CLIPlaygroundApplication::onNextInstructionButtonPressed, this), ButtonOption::Border());
+    step_over_button = Button("Step Over", std::bind(&CLIPlaygroundApplication::onStepOverButtonPressed, this), ButtonOption::Border());
+    step_out_button = Button("Step Out", std::bind(&CLIPlaygroundApplication::onStepOutButtonPressed, this), ButtonOption::Border());
+    run_to_cursor_button = Button("Run to Cursor", std::bind(&CLIPlaygroundApplication::onRunToCursorButtonPressed, this), ButtonOption::Border());
+    run_cycles_button = Button("Run Cycles", std::bind(&CLIPlaygroundApplication::onRunCyclesButtonPressed, this), ButtonOption::Border());
+    run_cycles_input = InputWord( &run_cycles_option );
     run_button = Button("Run", std::bind(&CLIPlaygroundApplication::onRunButtonPressed, this), ButtonOption::Border());
     pause_button = Button("Pause", std::bind(&CLIPlaygroundApplication::onPauseButtonPressed, this), ButtonOption::Border());
     reset_button = Button("Reset", std::bind(&CLIPlaygroundApplication::onResetButtonPressed, this), ButtonOption::Border());
     load_file_button = Button("Load File...", std::bind(&CLIPlaygroundApplication::onLoadFileButtonPressed, this), ButtonOption::Border());
     ui_update_rate_dropdown = Dropdown(&_ui_update_rates_dropdown_display_strings, &_selected_ui_rate);
+    clock_rate_dropdown = Dropdown(&_clock_rates_dropdown_display_strings, &_selected_clock_rate);
+    speed_dropdown = Dropdown(&_speeds_dropdown_display_strings, &_selected_speed);
     nmi_vector   = InputWord( &input_nmi_option );
     reset_vector = InputWord( &input_reset_option );
     irq_vector   = InputWord( &input_irq_option );
@@ -123,11 +224,14 @@ void CLIPlaygroundApplication::setup_ui()
     clock_ticks = Renderer(
         [&]()
         {
-            char buffer[16];
+            char buffer[24];
 
-            snprintf(buffer, sizeof(buffer), "%06u", computer.cpu()->clockTicks());
+            const uint64_t ticks = _simulation_running ? _emulation.snapshot().clock_ticks : computer.cpu()->clockTicks();
+
+            snprintf(buffer, sizeof(buffer), "%06llu", static_cast<unsigned long long>(ticks));
             return window( text("Clock Ticks"), text(buffer) ) | xflex;
         } );
+    performance = Renderer( std::bind( &CLIPlaygroundApplication::generatePerformanceView, this ) );
     system_vectors = Container::Vertical({ nmi_vector, reset_vector, irq_vector });
 
     disassembly_component = disassembly( &_disassembly_option );
@@ -137,12 +241,27 @@ void CLIPlaygroundApplication::setup_ui()
                                                                                Container::Vertical( { register_view_component,
                                                                                                       system_vectors } )
                                                                              }),
-                                                       Container::Horizontal({ step_button, next_instruction_button, run_button, pause_button, reset_button, load_file_button, ui_update_rate_dropdown }) }),
+                                                       Container::Horizontal({ step_button, next_instruction_button, step_over_button, step_out_button,
+                                                                               run_to_cursor_button, run_cycles_button, run_cycles_input,
+                                                                               run_button, pause_button, reset_button, load_file_button, ui_update_rate_dropdown,
+                                                                               clock_rate_dropdown, speed_dropdown }) }),
                                  std::bind( &CLIPlaygroundApplication::generateView, this )
                                );
     depth_1_renderer = InputDirectoryBrowser( &load_file_option );
-    main_container = Container::Tab({ depth_0_renderer, depth_1_renderer }, &main_tab_selection);
+
+    InputOption condition_input_option;
+
+    condition_input_option.on_enter = std::bind( &CLIPlaygroundApplication::onConditionFinished, this, true );
+    condition_input = Input( &_condition_text, "A == $FF && mem[$10] > 3", condition_input_option );
+    condition_ok_button = Button("Set", std::bind(&CLIPlaygroundApplication::onConditionFinished, this, true), ButtonOption::Border());
+    condition_cancel_button = Button("Cancel", std::bind(&CLIPlaygroundApplication::onConditionFinished, this, false), ButtonOption::Border());
+    depth_2_renderer = Renderer( Container::Vertical({ condition_input,
+                                                       Container::Horizontal({ condition_ok_button, condition_cancel_button }) }),
+                                 std::bind( &CLIPlaygroundApplication::generateConditionView, this ) );
+    main_container = Container::Tab({ depth_0_renderer, depth_1_renderer, depth_2_renderer }, &main_tab_selection);
     renderer = Renderer(main_container, [&] {
+        bindViews();
+
         Element document = depth_0_renderer->Render();
 
         if (main_tab_selection == 1) {
@@ -154,18 +273,30 @@ void CLIPlaygroundApplication::setup_ui()
                 depth_1_renderer->Render() | size(WIDTH, EQUAL, constant_width) | size(HEIGHT, EQUAL, constant_height) | clear_under | center,
                             });
         }
+        else if (main_tab_selection == 2) {
+            int constant_width  = static_cast<int>(screen.dimx() * 0.6f);
+
+            document = dbox({
+                document | dim,
+                depth_2_renderer->Render() | size(WIDTH, EQUAL, constant_width) | clear_under | center,
+                            });
+        }
         return document;
     });
 }
 
 void CLIPlaygroundApplication::onStepButtonPressed()
 {
+    EmulationThread::Suspension suspension( _emulation );
+
     computer.stepClock();
     Update();
 }
 
 void CLIPlaygroundApplication::onNextInstructionButtonPressed()
 {
+    EmulationThread::Suspension suspension( _emulation );
+
     computer.stepInstruction();
     Update();
 }
@@ -175,27 +306,179 @@ void CLIPlaygroundApplication::onRunButtonPressed()
     if ( _simulation_running )
         return;
 
+    startSimulation();
+}
+
+void CLIPlaygroundApplication::onStepOverButtonPressed()
+{
+    if ( _simulation_running )
+        return;
+
+    computer.stepOver();
+    startSimulation();
+}
+
+void CLIPlaygroundApplication::onStepOutButtonPressed()
+{
+    if ( _simulation_running )
+        return;
+
+    computer.stepOut();
+    startSimulation();
+}
+
+void CLIPlaygroundApplication::onRunToCursorButtonPressed()
+{
+    if ( _simulation_running )
+        return;
+
+    computer.runTo( _disassembly_option.selected_address() );
+    startSimulation();
+}
+
+void CLIPlaygroundApplication::onRunCyclesButtonPressed()
+{
+    if ( _simulation_running )
+        return;
+
+    computer.runCycles( *run_cycles_option.data );
+    startSimulation();
+}
+
+void CLIPlaygroundApplication::startSimulation()
+{
+    // The run targets are tested inside Computer::run(), so they all run on
+    // the emulation thread the same as a plain Run
+    _status_message.clear();
     _simulation_running = true;
+    _performance.restart( computer.cpu()->clockTicks(), computer.cpu()->instructionCount() );
+    _emulation.setClockRate( targetClockRate() );
+    _emulation.setFramePeriod( std::chrono::milliseconds( 1000 / targetUpdateRate() ) );
+    _emulation.resume();
 }
 
-void CLIPlaygroundApplication::updateTimeSlice()
+bool CLIPlaygroundApplication::updateFromEmulation()
 {
-    using namespace std::chrono_literals;
+    // Picks up a change of speed or update rate made while running
+    _emulation.setClockRate( targetClockRate() );
+    _emulation.setFramePeriod( std::chrono::milliseconds( 1000 / targetUpdateRate() ) );
 
-    auto start_time = std::chrono::steady_clock::now();
-    int hz = _ui_update_rates.at( _ui_update_rates_dropdown_display_strings[ _selected_ui_rate ] );
-    std::chrono::milliseconds frame_time{ 1000 / hz };
+    const bool updated = _emulation.updateSnapshot();
 
-    for (int count = 0; _simulation_running; ++count)
+    if ( updated )
     {
-        computer.stepClock();
-        if ( (count % 50) == 0 )
-        {
-            auto time_diff = std::chrono::steady_clock::now() - start_time;
+        const MachineSnapshot &snapshot = _emulation.snapshot();
 
-            if ( std::chrono::duration_cast<std::chrono::milliseconds>(time_diff) >= frame_time )
-                break;
-        }
+        _performance.addRunTime( snapshot.run_time - _reported_run_time );
+        _reported_run_time = snapshot.run_time;
+    }
+
+    const MachineSnapshot &snapshot = _emulation.snapshot();
+
+    _performance.frame( snapshot.clock_ticks, snapshot.instruction_count );
+
+    if ( !_emulation.resumed() )
+        onSimulationStopped( _emulation.stopReason() );
+    return updated;
+}
+
+void CLIPlaygroundApplication::bindViews()
+{
+    // Called before every render, as pausing takes the latest snapshot
+    const MachineSnapshot *snapshot = _simulation_running ? &_emulation.snapshot() : nullptr;
+
+    ram_view->setSnapshot( snapshot );
+    register_view->setSnapshot( snapshot );
+    _disassembly_option.snapshot = snapshot;
+    if ( snapshot )
+        _program_counter = snapshot->registers.program_counter;
+
+    // Writes to memory aren't signalled, so look for any to the vectors
+    // since the last frame.  The UI thread only has the memory while paused.
+    if ( snapshot )
+    {
+        if ( snapshot->changedSince( olc6502::NMIAddress, olc6502::IRQAddress + 1, _shown_generation ) )
+            updateSystemVectors( snapshot->memory );
+        _shown_generation = snapshot->generation;
+    }
+    else
+    {
+        RamBusDevice &ram = *computer.ram();
+
+        ram.collectChanges();
+        if ( ram.changedSince( olc6502::NMIAddress, olc6502::IRQAddress + 1, _shown_generation ) )
+            updateSystemVectors( ram.memory() );
+        _shown_generation = ram.generation();
+    }
+}
+
+void CLIPlaygroundApplication::updateSystemVectors(const RamBusDevice::memory_type &memory)
+{
+    *input_nmi_option.data   = MakeWord( memory[olc6502::NMIAddress], memory[olc6502::NMIAddress + 1] );
+    *input_reset_option.data = MakeWord( memory[olc6502::ResetJumpStartAddress], memory[olc6502::ResetJumpStartAddress + 1] );
+    *input_irq_option.data   = MakeWord( memory[olc6502::IRQAddress], memory[olc6502::IRQAddress + 1] );
+}
+
+int CLIPlaygroundApplication::targetUpdateRate() const
+{
+    return _ui_update_rates.at( _ui_update_rates_dropdown_display_strings[ _selected_ui_rate ] );
+}
+
+uint64_t CLIPlaygroundApplication::targetClockRate() const
+{
+    const uint64_t clock_rate = _clock_rates.at( _clock_rates_dropdown_display_strings[ _selected_clock_rate ] );
+
+    return static_cast<uint64_t>( std::llround( clock_rate * _speeds.at( _speeds_dropdown_display_strings[ _selected_speed ] ) ) );
+}
+
+Element CLIPlaygroundApplication::generatePerformanceView() const
+{
+    const PerformanceMonitor::Rates &rates = _performance.rates();
+    const uint64_t clock_rate = targetClockRate();
+    char speed[32];
+    char instructions[24];
+    char host_time[24];
+    char render_time[24];
+    char update_rate[24];
+
+    if ( clock_rate )
+        snprintf(speed, sizeof(speed), "%8.3f of %.3f MHz", rates.cycles_per_second / 1e6, clock_rate / 1e6);
+    else
+        snprintf(speed, sizeof(speed), "%8.3f MHz", rates.cycles_per_second / 1e6);
+    snprintf(instructions, sizeof(instructions), "%8.3f MIPS", rates.instructions_per_second / 1e6);
+    snprintf(host_time, sizeof(host_time), "%8.1f ns/instr", rates.host_ns_per_instruction);
+    snprintf(render_time, sizeof(render_time), "%8.2f ms/frame", rates.render_ms_per_frame);
+    snprintf(update_rate, sizeof(update_rate), "%5.1f of %d Hz", rates.frames_per_second, targetUpdateRate());
+
+    return window( text("Performance"), vbox({ text(speed),
+                                               text(instructions),
+                                               text(host_time),
+                                               text(render_time),
+                                               text(update_rate) }) ) | xflex;
+}
+
+void CLIPlaygroundApplication::onSimulationStopped(Computer::StopReason reason)
+{
+    char buffer[32];
+
+    // The emulation thread has handed the computer back, without having
+    // signalled any of the changes it made to the registers
+    _simulation_running = false;
+    _program_counter = computer.cpu()->pc();
+
+    if ( reason == Computer::StopReason::Breakpoint )
+    {
+        snprintf(buffer, sizeof(buffer), "Breakpoint at $%04X", computer.cpu()->pc());
+        _status_message = buffer;
+    }
+    else if ( reason == Computer::StopReason::Watchpoint )
+    {
+        const Breakpoints::Hit &hit = computer.breakpoints().hit();
+
+        snprintf(buffer, sizeof(buffer), "%s of $%04X",
+                 (hit.kind == Breakpoints::Write) ? "Write" : "Read",
+                 static_cast<unsigned int>(hit.address));
+        _status_message = buffer;
     }
 }
 
@@ -204,11 +487,22 @@ void CLIPlaygroundApplication::onPauseButtonPressed()
     if ( !_simulation_running )
         return;
 
+    if ( !_emulation.pause() )
+    {
+        // It had stopped by itself in the meantime
+        onSimulationStopped( _emulation.stopReason() );
+        return;
+    }
+
+    computer.cancelRunTarget();
     _simulation_running = false;
+    _program_counter = computer.cpu()->pc();
 }
 
 void CLIPlaygroundApplication::onResetButtonPressed()
 {
+    EmulationThread::Suspension suspension( _emulation );
+
     computer.cpu()->reset();
     computer.stepInstruction();
     screen.PostEvent(Event::Custom);
@@ -226,6 +520,7 @@ void CLIPlaygroundApplication::onLoadFileFinished(int button)
     if ( button == InputDirectoryOption::Ok )
     {
         filesystem::path file_to_load = load_file_option.curent_directory() / load_file_option.curent_file();
+        EmulationThread::Suspension suspension( _emulation );
 
         computer.loadProgram( QString::fromStdString( file_to_load.string() ) );
     }
@@ -233,6 +528,55 @@ void CLIPlaygroundApplication::onLoadFileFinished(int button)
     depth_0_renderer->TakeFocus();
 }
 
+void CLIPlaygroundApplication::onEditCondition(olc6502::addressType address)
+{
+    const BreakpointCondition *condition = computer.breakpointCondition( address );
+
+    _condition_address = address;
+    _condition_text = condition ? condition->expression() : std::string();
+    _condition_error.clear();
+    main_tab_selection = 2;
+    condition_input->TakeFocus();
+}
+
+void CLIPlaygroundApplication::onConditionFinished(bool accepted)
+{
+    if ( accepted )
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        if ( TrimWhitespace( _condition_text ).empty() )
+        {
+            computer.setBreakpointCondition( _condition_address, std::nullopt );
+        }
+        else
+        {
+            std::optional<BreakpointCondition> condition = BreakpointCondition::Compile( _condition_text, &_condition_error );
+
+            // Keep the dialog up so the expression can be fixed
+            if ( !condition )
+                return;
+
+            computer.setBreakpointCondition( _condition_address, std::move(condition) );
+        }
+    }
+    main_tab_selection = 0;
+    depth_0_renderer->TakeFocus();
+}
+
+Element CLIPlaygroundApplication::generateConditionView() const
+{
+    char title[32];
+
+    snprintf(title, sizeof(title), " Break at $%04X when ", static_cast<unsigned int>(_condition_address));
+
+    return window( text(title) | hcenter,
+                   vbox({ condition_input->Render(),
+                          text( _condition_error ) | color(Color::Red),
+                          hbox({ filler(), condition_ok_button->Render(), condition_cancel_button->Render() })
+                        }) );
+}
+
 bool CLIPlaygroundApplication::catchEvent(Event event)
 {
     _previous_event = event;
@@ -242,12 +586,39 @@ bool CLIPlaygroundApplication::catchEvent(Event event)
         screen.ExitLoopClosure()();
         return true;
     }
+    else if (event == Event::F2)
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        computer.exportFlightRecorder( QStringLiteral("flightrecorder.txt") );
+        return true;
+    }
+    else if (event == Event::F3)
+    {
+        EmulationThread::Suspension suspension( _emulation );
+
+        // Start profiling afresh, or stop and write the report
+        if ( computer.profileEnabled() )
+        {
+            computer.setProfileEnabled( false );
+            computer.exportProfile( QStringLiteral("profile.txt") );
+            _status_message = "Profile written to profile.txt";
+        }
+        else
+        {
+            computer.clearProfile();
+            computer.setProfileEnabled( true );
+            _status_message = "Profiling";
+        }
+        return true;
+    }
 
     return false;
 }
 
 int CLIPlaygroundApplication::mainLoop()
 {
+    _emulation.start();
     step_button->TakeFocus();
     computer.stepInstruction();
 
@@ -257,16 +628,33 @@ int CLIPlaygroundApplication::mainLoop()
 
     while ( !loop.HasQuitted() )
     {
-        loop.RunOnce();
+        PROFILE_ZONE("Frame");
+        auto render_start_time = std::chrono::steady_clock::now();
 
-        if ( _simulation_running )
+        if ( !_simulation_running )
         {
-            // Run one "unit"/time-slice of the simulation
-            updateTimeSlice();
-            screen.PostEvent(Event::Custom);
+            // Nothing changes while paused except in answer to an event, so
+            // sleep until there is one
+            loop.RunOnceBlocking();
+            continue;
         }
+
+        loop.RunOnce();
+        if ( !_simulation_running )
+            continue; // Paused by the event just handled
+
+        // Only frames that run the simulation are measured
+        _performance.addRenderTime( std::chrono::steady_clock::now() - render_start_time );
+
+        // The simulation runs on its own thread, so the rest of the frame
+        // is just waiting for it to get further.  Only a new snapshot (or
+        // the simulation stopping) needs drawing.
+        std::this_thread::sleep_until( render_start_time + std::chrono::milliseconds( 1000 / targetUpdateRate() ) );
+        if ( updateFromEmulation() || !_simulation_running )
+            screen.PostEvent(Event::Custom);
     }
 
+    PROFILE_DUMP("trace.json");
     return EXIT_SUCCESS;
 }
 
@@ -277,6 +665,7 @@ Element CLIPlaygroundApplication::generateView() const
                                                                   window( text("Disassembly"), disassembly_component->Render() ) | size(HEIGHT, EQUAL, 17),
                                                                   vbox({ register_view_component->Render(),
                                                                          clock_ticks->Render(),
+                                                                         performance->Render(),
                                                                      window( text("System Vectors"),
                                                                             vbox({ hbox({ text("NMI:   "), nmi_vector->Render() }),
                                                                                    hbox({ text("RESET: "), reset_vector->Render() }),
@@ -286,39 +675,20 @@ Element CLIPlaygroundApplication::generateView() const
                                                            separatorDouble(),
                                                            hbox({ step_button->Render(),
                                                                   next_instruction_button->Render(),
+                                                                  step_over_button->Render(),
+                                                                  step_out_button->Render(),
+                                                                  run_to_cursor_button->Render(),
+                                                                  run_cycles_button->Render(),
+                                                                  run_cycles_input->Render() | vcenter,
+                                                                  text(" (up to 65535)") | dim | vcenter, // The input is 16-bit
                                                                   run_button->Render(),
                                                                   pause_button->Render(),
                                                                   reset_button->Render(),
                                                                   load_file_button->Render(),
-                                                                  ui_update_rate_dropdown->Render() }) | size(HEIGHT, GREATER_THAN, 2)
+                                                                  ui_update_rate_dropdown->Render(),
+                                                                  clock_rate_dropdown->Render(),
+                                                                  speed_dropdown->Render(),
+                                                                  text( _status_message ) | color(Color::Red) | vcenter }) | size(HEIGHT, GREATER_THAN, 2)
                                                            })
                  );
 }
-
-void CLIPlaygroundApplication::memoryChanged(IBusDevice::addressType address, uint8_t data)
-{
-    if ( address == olc6502::ResetJumpStartAddress )
-    {
-        *input_reset_option.data = MakeWord( data, HighByteOf( *input_reset_option.data ) );
-    }
-    else if ( address == olc6502::ResetJumpStartAddress + 1 )
-    {
-        *input_reset_option.data = MakeWord( LowByteOf( *input_reset_option.data ), data );
-    }
-    else if ( address == olc6502::NMIAddress )
-    {
-        *input_nmi_option.data = MakeWord( data, HighByteOf( *input_nmi_option.data ) );
-    }
-    else if ( address == olc6502::NMIAddress + 1 )
-    {
-        *input_nmi_option.data = MakeWord( LowByteOf( *input_nmi_option.data ), data );
-    }
-    else if ( address == olc6502::IRQAddress )
-    {
-        *input_irq_option.data = MakeWord( data, HighByteOf( *input_irq_option.data ) );
-    }
-    else if ( address == olc6502::IRQAddress + 1 )
-    {
-        *input_irq_option.data = MakeWord( LowByteOf( *input_irq_option.data ), data );
-    }
-}
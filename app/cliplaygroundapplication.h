@@ -11,6 +11,9 @@
 #include "emulator/disassembly.hpp"
 #include "ui/components/inputnumber.hpp"
 #include "ui/components/directorybrowser.hpp"
+#include "performancemonitor.hpp"
+#include "statisticsexporter.hpp"
+#include "emulationthread.hpp"
 #include <memory>
 #include <map>
 #include <vector>
@@ -36,10 +39,12 @@ public:
     InputWordOption              input_reset_option;
     InputWordOption              input_irq_option;
     InputDirectoryOption         load_file_option;
+    InputWordOption              run_cycles_option;
     ftxui::Component             memory_page_component;
     ftxui::Component             register_view_component;
     ftxui::Component             disassembly_component;
     ftxui::Component             clock_ticks;
+    ftxui::Component             performance;
     ftxui::Component             system_vectors;
     ftxui::Component             nmi_vector;
     ftxui::Component             reset_vector;
@@ -48,13 +53,24 @@ public:
     ftxui::Component             run_button;
     ftxui::Component             pause_button;
     ftxui::Component             next_instruction_button;
+    ftxui::Component             step_over_button;
+    ftxui::Component             step_out_button;
+    ftxui::Component             run_to_cursor_button;
+    ftxui::Component             run_cycles_button;
+    ftxui::Component             run_cycles_input;
     ftxui::Component             reset_button;
     ftxui::Component             load_file_button;
     ftxui::Component             ui_update_rate_dropdown;
+    ftxui::Component             clock_rate_dropdown;
+    ftxui::Component             speed_dropdown;
     ftxui::Component             main_tab;
     ftxui::Component             main_container;
     ftxui::Component             depth_0_renderer;
     ftxui::Component             depth_1_renderer;
+    ftxui::Component             condition_input;
+    ftxui::Component             condition_ok_button;
+    ftxui::Component             condition_cancel_button;
+    ftxui::Component             depth_2_renderer;
     ftxui::Component             renderer;
     ftxui::ScreenInteractive     screen{ ftxui::ScreenInteractive::Fullscreen() };
     int                          main_tab_selection = 0;
@@ -68,6 +84,15 @@ protected:
     int               _program_counter = 0;
     bool              _simulation_running = false;
     int               _selected_ui_rate = 3;
+    std::string       _status_message; ///< Why the simulation last stopped on its own
+    PerformanceMonitor _performance;
+    PerformanceMonitor::clockType::duration _reported_run_time{}; ///< Of the emulation thread, as far as _performance has been told
+    EmulationThread   _emulation{ computer };
+    uint64_t          _shown_generation = 0; ///< Of the memory the system vectors were last updated from
+    std::unique_ptr<StatisticsExporter> _statistics_exporter;
+    std::string       _condition_text;
+    std::string       _condition_error;
+    olc6502::addressType _condition_address = 0;
     std::map<std::string, int> _ui_update_rates{ { " 5 Hz",  5 },
                                                  { "10 Hz", 10 },
                                                  { "20 Hz", 20 },
@@ -76,20 +101,47 @@ protected:
                                                  { "60 Hz", 60 },
                                                  { "72 Hz", 72 } };
     std::vector<std::string> _ui_update_rates_dropdown_display_strings;
+    int               _selected_clock_rate = 2;
+    std::map<std::string, uint64_t> _clock_rates{ { "1.023 MHz", 1'023'000 },
+                                                  { "2.000 MHz", 2'000'000 },
+                                                  { "Warp",      0 } }; ///< Runs unthrottled
+    std::vector<std::string> _clock_rates_dropdown_display_strings;
+    int               _selected_speed = 2;
+    std::map<std::string, double> _speeds{ { "  0.1x",   0.1 },
+                                           { "  0.5x",   0.5 },
+                                           { "  1.0x",   1.0 },
+                                           { "  2.0x",   2.0 },
+                                           { " 10.0x",  10.0 },
+                                           { "100.0x", 100.0 } };
+    std::vector<std::string> _speeds_dropdown_display_strings;
 
     static CLIPlaygroundApplication *_Instance;
 
     void onStepButtonPressed();
     void onNextInstructionButtonPressed();
     void onRunButtonPressed();
+    void onStepOverButtonPressed();
+    void onStepOutButtonPressed();
+    void onRunToCursorButtonPressed();
+    void onRunCyclesButtonPressed();
+    void startSimulation();
     void onPauseButtonPressed();
     void onResetButtonPressed();
     void onLoadFileButtonPressed();
     void onLoadFileFinished(int button);
+    void onEditCondition(olc6502::addressType address);
+    void onConditionFinished(bool accepted);
+    ftxui::Element generateConditionView() const;
     bool catchEvent(ftxui::Event event);
     ftxui::Element generateView() const;
-    void updateTimeSlice();
-    void memoryChanged(IBusDevice::addressType address, uint8_t data);
+    bool updateFromEmulation(); ///< Returns true if there was a newer snapshot to draw
+    void bindViews();
+    void updateSystemVectors(const RamBusDevice::memory_type &memory);
+    void parseCommandLine();
+    int  targetUpdateRate() const;
+    uint64_t targetClockRate() const;
+    ftxui::Element generatePerformanceView() const;
+    void onSimulationStopped(Computer::StopReason reason);
 
 protected slots:
 };
@@ -0,0 +1,60 @@
+#include "clockpacer.hpp"
+#include <algorithm>
+#include <thread>
+
+
+void ClockPacer::setRate(uint64_t cycles_per_second)
+{
+    _rate = cycles_per_second;
+    _cycles = 0;
+}
+
+void ClockPacer::restart(clockType::time_point now)
+{
+    _start = now;
+    _cycles = 0;
+}
+
+uint32_t ClockPacer::sliceCycles(uint32_t most) const
+{
+    if ( !throttled() )
+        return most;
+
+    const uint64_t cycles = _rate * Slice.count() / std::chrono::microseconds( std::chrono::seconds(1) ).count();
+
+    return static_cast<uint32_t>( std::clamp<uint64_t>( cycles, 1, most ) );
+}
+
+ClockPacer::clockType::time_point ClockPacer::ran(uint64_t cycles, clockType::time_point now)
+{
+    if ( !throttled() )
+        return now;
+
+    _cycles += cycles;
+
+    // Move the start along a whole second at a time, which is exact
+    while ( _cycles >= _rate )
+    {
+        _cycles -= _rate;
+        _start += std::chrono::seconds(1);
+    }
+
+    const clockType::time_point due = _start + std::chrono::duration_cast<clockType::duration>(
+                                                   std::chrono::nanoseconds( _cycles * 1'000'000'000 / _rate ) );
+
+    if ( now - due > MaximumLag )
+    {
+        restart( now );
+        return now;
+    }
+    return due;
+}
+
+void ClockPacer::WaitUntil(clockType::time_point due)
+{
+    if ( due - clockType::now() > SpinMargin )
+        std::this_thread::sleep_until( due - SpinMargin );
+
+    while ( clockType::now() < due )
+        std::this_thread::yield();
+}
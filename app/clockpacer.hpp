@@ -0,0 +1,68 @@
+#ifndef CLOCKPACER_HPP
+#define CLOCKPACER_HPP
+
+#include <chrono>
+#include <cstdint>
+
+
+/** Keeps the emulated clock running at a given rate against the host's clock.
+ *
+ *  The CPU is run in slices of about @c Slice worth of cycles, and after
+ *  each one the pacer sleeps until the time the cycles run so far are due.
+ *  That time is worked out from when pacing started rather than from the
+ *  end of the last slice, so oversleeping in one slice is made up in the
+ *  next instead of adding up.  Sleeping stops a little short and the rest is
+ *  waited out yielding, which is far more precise than the sleep alone
+ *  without keeping a core busy.
+ *
+ *  Falling more than @c MaximumLag behind (the host was busy, or the run was
+ *  paused for a moment) starts pacing afresh from the current time, rather
+ *  than running flat-out to catch up.
+ *
+ *  A rate of 0 means unthrottled: slices are as big as allowed and there is
+ *  never any waiting.
+ */
+class ClockPacer
+{
+public:
+    using clockType = std::chrono::steady_clock;
+
+    static constexpr std::chrono::microseconds Slice{ 1000 };
+    static constexpr std::chrono::milliseconds MaximumLag{ 50 };
+    static constexpr std::chrono::microseconds SpinMargin{ 100 }; ///< How much of a wait is spent yielding instead of asleep
+
+    /** @param cycles_per_second The rate to keep to, or 0 to run unthrottled.
+     *                           Pacing starts afresh from the next @c restart().
+     */
+    void setRate(uint64_t cycles_per_second);
+
+    uint64_t rate() const { return _rate; }
+    bool throttled() const { return _rate != 0; }
+
+    /// Starts pacing from @p now, forgetting how far ahead or behind it was.
+    void restart(clockType::time_point now);
+
+    /** How many cycles to run in the next slice.
+     *
+     *  @param most The most that may be run at a time
+     */
+    uint32_t sliceCycles(uint32_t most) const;
+
+    /** Counts cycles that have been run.
+     *
+     *  @param cycles The number of cycles run since the last call
+     *  @param now    The time they finished
+     *  @return The time they are due, which is @p now when unthrottled or too far behind
+     */
+    clockType::time_point ran(uint64_t cycles, clockType::time_point now);
+
+    /// Waits until @p due, sleeping for most of it.
+    static void WaitUntil(clockType::time_point due);
+
+protected:
+    uint64_t              _rate = 0;
+    clockType::time_point _start;      ///< When the cycles counted in _cycles started
+    uint64_t              _cycles = 0; ///< Run since _start.  Kept under a second's worth so the sums can't overflow.
+};
+
+#endif // CLOCKPACER_HPP
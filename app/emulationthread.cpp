@@ -0,0 +1,174 @@
+#include "emulationthread.hpp"
+#include "utilities/Profiling.hpp"
+
+
+EmulationThread::EmulationThread(Computer &computer, QObject *parent)
+    :
+    QThread(parent),
+    _computer(computer)
+{
+}
+
+EmulationThread::~EmulationThread()
+{
+    if ( isRunning() )
+    {
+        post( Command::Quit );
+        wait();
+    }
+}
+
+void EmulationThread::post(Command command)
+{
+    // Only a handful are ever in flight, since pause() waits for its answer
+    while ( !_commands.push( command ) )
+        QThread::yieldCurrentThread();
+    _wake.release();
+}
+
+void EmulationThread::resume()
+{
+    if ( _resumed )
+        return;
+
+    _resumed = true;
+    post( Command::Run );
+    _acknowledged.acquire();
+    _snapshots->acquire();
+}
+
+bool EmulationThread::pause()
+{
+    if ( !_resumed )
+        return false;
+
+    post( Command::Pause );
+    _acknowledged.acquire();
+    _resumed = false;
+
+    // The latest snapshot is from this run, and tells whether it had
+    // already stopped by itself
+    _snapshots->acquire();
+    return _snapshots->front().running;
+}
+
+bool EmulationThread::updateSnapshot()
+{
+    if ( !_snapshots->acquire() )
+        return false;
+
+    if ( !_snapshots->front().running )
+        _resumed = false;
+    return true;
+}
+
+void EmulationThread::run()
+{
+    while ( true )
+    {
+        if ( !_running )
+        {
+            // Nothing to do until the next command
+            _wake.acquire();
+        }
+        else if ( !_wake.tryAcquire() )
+        {
+            runBatch();
+            continue;
+        }
+
+        std::optional<Command> command = _commands.pop();
+
+        if ( !command )
+            continue;
+
+        switch ( *command )
+        {
+        case Command::Run:
+            _running = true;
+            _pacer.restart( ClockPacer::clockType::now() );
+            _computer.setChangeSignalsEnabled( false );
+            publish();
+            _acknowledged.release();
+            break;
+        case Command::Pause:
+            park();
+            _acknowledged.release();
+            break;
+        case Command::Quit:
+            park();
+            return;
+        }
+    }
+}
+
+void EmulationThread::runBatch()
+{
+    const uint64_t clock_rate = _clock_rate.load( std::memory_order_relaxed );
+
+    if ( clock_rate != _pacer.rate() )
+    {
+        _pacer.setRate( clock_rate );
+        _pacer.restart( ClockPacer::clockType::now() );
+    }
+
+    _batch_sizer.setTarget( std::chrono::steady_clock::duration( _frame_period.load( std::memory_order_relaxed ) ) / BatchesPerFrame );
+
+    const uint64_t start_ticks = _computer.cpu()->clockTicks();
+    auto start_time = std::chrono::steady_clock::now();
+    Computer::StopReason reason;
+
+    {
+        PROFILE_ZONE("Computer::run");
+        reason = _computer.run( _pacer.sliceCycles( _batch_sizer.cycles() ) );
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    const uint64_t cycles_run = _computer.cpu()->clockTicks() - start_ticks;
+
+    _run_time += end_time - start_time;
+    _batch_sizer.ran( cycles_run, end_time - start_time );
+
+    if ( reason != Computer::StopReason::Completed )
+    {
+        // The last snapshot hands the computer back, so be done with it first
+        _stop_reason = reason;
+        park();
+        publish();
+    }
+    else if ( _snapshots->consumed() )
+    {
+        // No point copying memory faster than the UI draws it
+        publish();
+    }
+
+    if ( _running && _pacer.throttled() )
+        ClockPacer::WaitUntil( _pacer.ran( cycles_run, end_time ) );
+}
+
+void EmulationThread::park()
+{
+    if ( !_running )
+        return;
+
+    _running = false;
+    _computer.setChangeSignalsEnabled( true );
+}
+
+void EmulationThread::publish()
+{
+    MachineSnapshot &snapshot = _snapshots->back();
+    const olc6502 &cpu = *_computer.cpu();
+
+    snapshot.registers = cpu.registers();
+    snapshot.clock_ticks = cpu.clockTicks();
+    snapshot.instruction_count = cpu.instructionCount();
+    snapshot.usage_monitor = cpu.usageMonitor();
+    snapshot.run_time = _run_time;
+    snapshot.running = _running;
+
+    RamBusDevice &ram = *_computer.ram();
+    const uint64_t generation = ram.collectChanges();
+
+    _snapshots->publish( ram.memory(), ram.pageGenerations(), generation );
+}
@@ -0,0 +1,142 @@
+#ifndef EMULATIONTHREAD_HPP
+#define EMULATIONTHREAD_HPP
+
+#include <QThread>
+#include <QSemaphore>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "batchsizer.hpp"
+#include "clockpacer.hpp"
+#include "emulator/computer.hpp"
+#include "emulator/machinesnapshot.hpp"
+#include "utilities/SpscQueue.hpp"
+
+
+/** Runs the computer on a thread of its own, so drawing the UI never holds up the emulation.
+ *
+ *  The computer belongs to whichever thread is using it.  While the UI
+ *  thread has it, it is used exactly as before.  @c resume() hands it over
+ *  to this thread, which runs it in batches of cycles until it stops on its
+ *  own (a breakpoint, a watchpoint or a run target) or until @c pause()
+ *  takes it back.
+ *
+ *  While it runs, this thread publishes snapshots of the registers, the
+ *  clock and memory, and the views draw from the latest one without ever
+ *  waiting.  Commands go the other way through a lock-free queue, and are
+ *  picked up between batches.
+ *
+ *  The clock runs flat-out unless a clock rate is set, in which case the
+ *  batches are paced to keep to it.
+ *
+ *  Everything here but @c run() is to be called from the UI thread.
+ */
+class EmulationThread : public QThread
+{
+    Q_OBJECT
+public:
+    /// How many batches are run per frame of the UI, which is also how many snapshots it has to choose from
+    static constexpr int BatchesPerFrame = 4;
+
+    /** @param computer The computer to run.  It must outlive the thread.
+     */
+    explicit EmulationThread(Computer &computer, QObject *parent = nullptr);
+   ~EmulationThread() override;
+
+    /** Hands the computer over to this thread and starts running it, from wherever it is.
+     *
+     *  Waits for the first snapshot of the run, which is only as long as
+     *  copying memory takes, so that @c snapshot() is never out of date.
+     */
+    void resume();
+
+    /** Stops running the computer and takes it back, waiting for the batch
+     *  in progress to finish.  Does nothing unless it is running.
+     *
+     *  @return true if it was still running, false if it had already stopped on its own
+     */
+    bool pause();
+
+    /// Tells whether this thread has the computer, as far as the UI thread knows.
+    bool resumed() const { return _resumed; }
+
+    /** Takes the latest snapshot.
+     *
+     *  When it is the last of a run, the computer has stopped and is handed
+     *  back: @c resumed() is then false and @c stopReason() tells why.
+     *
+     *  @return true if there was a newer snapshot
+     */
+    bool updateSnapshot();
+
+    /// The snapshot taken last, which is from the current run while @c resumed()
+    const MachineSnapshot &snapshot() const { return _snapshots->front(); }
+
+    /** Sets the rate to run the clock at, which takes effect with the next batch.
+     *
+     *  @param cycles_per_second The rate, or 0 to run as fast as possible
+     */
+    void setClockRate(uint64_t cycles_per_second) { _clock_rate.store( cycles_per_second, std::memory_order_relaxed ); }
+
+    /** Sets how often the UI draws a frame, which takes effect with the next batch.
+     *
+     *  Batches are sized to take a fraction of it, so there is always a
+     *  snapshot less than a frame old to draw and pausing never holds up the
+     *  UI for long.
+     */
+    void setFramePeriod(std::chrono::steady_clock::duration period) { _frame_period.store( period.count(), std::memory_order_relaxed ); }
+
+    /// Why the last run stopped on its own
+    Computer::StopReason stopReason() const { return _stop_reason; }
+
+    /** Keeps the computer on the UI thread for as long as it is in scope.
+     *
+     *  Anything that changes the computer while it might be running does so
+     *  inside one of these.  A run in progress is paused for the duration,
+     *  which is at most one batch, and carries on afterwards.
+     */
+    class Suspension
+    {
+    public:
+        explicit Suspension(EmulationThread &thread) : _thread(thread), _resume( thread.pause() ) {}
+       ~Suspension() { if ( _resume ) _thread.resume(); }
+
+        Suspension(const Suspension &) = delete;
+        Suspension &operator =(const Suspension &) = delete;
+    protected:
+        EmulationThread &_thread;
+        const bool       _resume;
+    };
+
+protected:
+    enum class Command
+    {
+        Run,   ///< Start running the computer, and say so through _acknowledged
+        Pause, ///< Stop running it, and say so through _acknowledged
+        Quit   ///< Stop running it and end the thread
+    };
+
+    Computer                  &_computer;
+    SpscQueue<Command, 16>     _commands;
+    QSemaphore                 _wake;   ///< Released once for every command queued
+    QSemaphore                 _acknowledged; ///< Released once a Run or Pause has been carried out
+    std::unique_ptr<SnapshotBuffer> _snapshots{ std::make_unique<SnapshotBuffer>() };
+    bool                       _resumed = false; ///< Only used by the UI thread
+    std::atomic<uint64_t>      _clock_rate{ 0 };
+    std::atomic<std::chrono::steady_clock::rep> _frame_period{ std::chrono::steady_clock::duration( std::chrono::milliseconds(33) ).count() };
+
+    // Only used by this thread, or while it doesn't have the computer
+    bool                       _running = false;
+    Computer::StopReason       _stop_reason = Computer::StopReason::Completed;
+    std::chrono::steady_clock::duration _run_time{};
+    ClockPacer                 _pacer;
+    BatchSizer                 _batch_sizer;
+
+    void post(Command command);
+    void run() override;
+    void runBatch();
+    void park();
+    void publish();
+};
+
+#endif // EMULATIONTHREAD_HPP
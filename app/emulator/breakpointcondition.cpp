@@ -0,0 +1,500 @@
+#include "breakpointcondition.hpp"
+#include "utilities/StringConversions.hpp"
+#include <algorithm>
+#include <cctype>
+
+
+namespace
+{
+
+struct Token
+{
+    enum Type { End, Number, Name, Operator, LeftParen, RightParen, LeftBracket, RightBracket, Invalid };
+
+    Type                          type = End;
+    std::string_view              text;
+    BreakpointCondition::valueType value = 0;
+};
+
+bool IsNameCharacter(int c)
+{
+    return std::isalnum(c) || (c == '_');
+}
+
+bool IsBinaryDigit(int c)
+{
+    return (c == '0') || (c == '1');
+}
+
+std::string Lowered(std::string_view text)
+{
+    std::string result{ text };
+
+    std::transform( result.begin(), result.end(), result.begin(), [](unsigned char c) { return std::tolower(c); } );
+    return result;
+}
+
+class Tokenizer
+{
+public:
+    explicit Tokenizer(std::string_view input) : _input(input) { advance(); }
+
+    const Token &current() const { return _current; }
+
+    void advance()
+    {
+        _input = EatLeadingWhiteSpace( _input );
+        _follows_value = (_current.type == Token::Number) || (_current.type == Token::Name) ||
+                         (_current.type == Token::RightParen) || (_current.type == Token::RightBracket);
+        _current = next();
+    }
+
+protected:
+    std::string_view _input;
+    Token            _current;
+    bool             _follows_value = false; // Tells a binary number from the modulo operator
+
+    Token take(Token::Type type, size_t length, BreakpointCondition::valueType value = 0)
+    {
+        Token token{ type, _input.substr(0, length), value };
+
+        _input.remove_prefix( length );
+        return token;
+    }
+
+    Token number(size_t prefix_length, int base, bool (*is_digit)(int))
+    {
+        size_t length = prefix_length;
+        int64_t value = 0;
+
+        while ( (length < _input.size()) && is_digit(_input[length]) )
+        {
+            int digit = std::isdigit(_input[length]) ? (_input[length] - '0') : (std::tolower(_input[length]) - 'a' + 10);
+
+            value = value * base + digit;
+            if ( value > INT32_MAX )
+                return take( Token::Invalid, length + 1 );
+            ++length;
+        }
+
+        if ( (length == prefix_length) || ((length < _input.size()) && IsNameCharacter(_input[length])) )
+            return take( Token::Invalid, length + 1 > _input.size() ? _input.size() : length + 1 );
+
+        return take( Token::Number, length, static_cast<BreakpointCondition::valueType>(value) );
+    }
+
+    Token next()
+    {
+        static constexpr std::string_view TwoCharacterOperators[] = { "||", "&&", "==", "!=", "<=", ">=", "<<", ">>" };
+
+        if ( _input.empty() )
+            return {};
+
+        char c = _input.front();
+
+        if ( c == '$' )
+            return number( 1, 16, &IsHexDigit );
+        if ( (c == '%') && !_follows_value && (_input.size() > 1) && IsBinaryDigit(_input[1]) )
+            return number( 1, 2, &IsBinaryDigit );
+        if ( (c == '0') && (_input.size() > 1) && ((_input[1] == 'x') || (_input[1] == 'X')) )
+            return number( 2, 16, &IsHexDigit );
+        if ( std::isdigit(c) )
+            return number( 0, 10, &IsDecimalDigit );
+        if ( std::isalpha(c) || (c == '_') )
+        {
+            size_t length = 1;
+
+            while ( (length < _input.size()) && IsNameCharacter(_input[length]) )
+                ++length;
+            return take( Token::Name, length );
+        }
+
+        switch (c)
+        {
+        case '(': return take( Token::LeftParen, 1 );
+        case ')': return take( Token::RightParen, 1 );
+        case '[': return take( Token::LeftBracket, 1 );
+        case ']': return take( Token::RightBracket, 1 );
+        default:
+            break;
+        }
+
+        for (std::string_view iCurrentOperator : TwoCharacterOperators)
+        {
+            if ( _input.substr(0, 2) == iCurrentOperator )
+                return take( Token::Operator, 2 );
+        }
+
+        if ( std::string_view("|^&<>+-*/%!~").find(c) != std::string_view::npos )
+            return take( Token::Operator, 1 );
+
+        return take( Token::Invalid, 1 );
+    }
+};
+
+}
+
+class BreakpointConditionCompiler
+{
+public:
+    using OpCode = BreakpointCondition::OpCode;
+
+    BreakpointConditionCompiler(std::string_view expression, BreakpointCondition &output)
+        :
+        _tokens(expression),
+        _output(output)
+    {
+    }
+
+    bool compile()
+    {
+        if ( !parseBinary(0) )
+            return false;
+
+        if ( _tokens.current().type != Token::End )
+            return fail("Unexpected \"" + std::string(_tokens.current().text) + "\"");
+
+        return true;
+    }
+
+    const std::string &error() const { return _error; }
+
+protected:
+    struct BinaryOperator
+    {
+        std::string_view text;
+        int              precedence;
+        OpCode           op;
+    };
+
+    // Logical operators are handled separately since they short-circuit
+    static constexpr int OrPrecedence  = 1;
+    static constexpr int AndPrecedence = 2;
+
+    static const BinaryOperator *FindBinaryOperator(std::string_view text)
+    {
+        static constexpr BinaryOperator Operators[] = {
+            { "||", OrPrecedence,  BreakpointCondition::OrJump },
+            { "&&", AndPrecedence, BreakpointCondition::AndJump },
+            { "|",  3, BreakpointCondition::BitOr },
+            { "^",  4, BreakpointCondition::BitXor },
+            { "&",  5, BreakpointCondition::BitAnd },
+            { "==", 6, BreakpointCondition::Equal },
+            { "!=", 6, BreakpointCondition::NotEqual },
+            { "<",  7, BreakpointCondition::Less },
+            { "<=", 7, BreakpointCondition::LessEqual },
+            { ">",  7, BreakpointCondition::Greater },
+            { ">=", 7, BreakpointCondition::GreaterEqual },
+            { "<<", 8, BreakpointCondition::ShiftLeft },
+            { ">>", 8, BreakpointCondition::ShiftRight },
+            { "+",  9, BreakpointCondition::Add },
+            { "-",  9, BreakpointCondition::Subtract },
+            { "*", 10, BreakpointCondition::Multiply },
+            { "/", 10, BreakpointCondition::Divide },
+            { "%", 10, BreakpointCondition::Modulo }
+        };
+
+        for (const BinaryOperator &iCurrentOperator : Operators)
+        {
+            if ( iCurrentOperator.text == text )
+                return &iCurrentOperator;
+        }
+        return nullptr;
+    }
+
+    Tokenizer            _tokens;
+    BreakpointCondition &_output;
+    std::string          _error;
+    size_t               _depth = 0;
+    size_t               _nesting = 0; ///< How deeply the parser has recursed
+
+    static constexpr size_t MaxNesting = 256;
+
+    bool fail(std::string message)
+    {
+        if ( _error.empty() )
+            _error = std::move(message);
+        return false;
+    }
+
+    bool append(OpCode op, BreakpointCondition::valueType operand = 0)
+    {
+        switch (op)
+        {
+        case BreakpointCondition::PushConstant:
+        case BreakpointCondition::PushA:
+        case BreakpointCondition::PushX:
+        case BreakpointCondition::PushY:
+        case BreakpointCondition::PushSP:
+        case BreakpointCondition::PushPC:
+        case BreakpointCondition::PushStatus:
+        case BreakpointCondition::PushFlag:
+            if ( ++_depth > BreakpointCondition::MaxStackDepth )
+                return fail("Expression is too deeply nested");
+            break;
+        case BreakpointCondition::LoadByte:
+        case BreakpointCondition::LoadWord:
+        case BreakpointCondition::Negate:
+        case BreakpointCondition::Complement:
+        case BreakpointCondition::Not:
+        case BreakpointCondition::ToBool:
+            break;
+        default:
+            // Binary operators, and the logical jumps when they fall through
+            --_depth;
+            break;
+        }
+
+        _output._code.push_back( { op, operand } );
+        return true;
+    }
+
+    bool expect(Token::Type type, const char *what)
+    {
+        if ( _tokens.current().type != type )
+            return fail(std::string("Expected ") + what);
+
+        _tokens.advance();
+        return true;
+    }
+
+    // Precedence climbing over the binary operators
+    bool parseBinary(int minimum_precedence)
+    {
+        if ( !parseUnary() )
+            return false;
+
+        while ( _tokens.current().type == Token::Operator )
+        {
+            const BinaryOperator *binary_operator = FindBinaryOperator( _tokens.current().text );
+
+            if ( !binary_operator || (binary_operator->precedence <= minimum_precedence) )
+                break;
+
+            _tokens.advance();
+
+            if ( (binary_operator->precedence == OrPrecedence) || (binary_operator->precedence == AndPrecedence) )
+            {
+                size_t jump = _output._code.size();
+
+                if ( !append(binary_operator->op) )
+                    return false;
+                if ( !parseBinary(binary_operator->precedence) )
+                    return false;
+                if ( !append(BreakpointCondition::ToBool) )
+                    return false;
+                _output._code[jump].operand = static_cast<BreakpointCondition::valueType>(_output._code.size());
+            }
+            else
+            {
+                if ( !parseBinary(binary_operator->precedence) )
+                    return false;
+                if ( !append(binary_operator->op) )
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool parseUnary()
+    {
+        // Every level of parentheses, brackets and unary operators comes through here
+        if ( ++_nesting > MaxNesting )
+            return fail("Expression is too deeply nested");
+
+        const bool parsed = parseUnaryOperator();
+
+        --_nesting;
+        return parsed;
+    }
+
+    bool parseUnaryOperator()
+    {
+        if ( _tokens.current().type == Token::Operator )
+        {
+            OpCode op;
+
+            if ( _tokens.current().text == "-" )
+                op = BreakpointCondition::Negate;
+            else if ( _tokens.current().text == "~" )
+                op = BreakpointCondition::Complement;
+            else if ( _tokens.current().text == "!" )
+                op = BreakpointCondition::Not;
+            else
+                return fail("Unexpected \"" + std::string(_tokens.current().text) + "\"");
+
+            _tokens.advance();
+            return parseUnary() && append(op);
+        }
+        return parsePrimary();
+    }
+
+    bool parsePrimary()
+    {
+        const Token token = _tokens.current();
+
+        switch (token.type)
+        {
+        case Token::Number:
+            _tokens.advance();
+            return append(BreakpointCondition::PushConstant, token.value);
+        case Token::LeftParen:
+            _tokens.advance();
+            return parseBinary(0) && expect(Token::RightParen, "\")\"");
+        case Token::Name:
+            _tokens.advance();
+            return parseName( token.text );
+        case Token::End:
+            return fail("Unexpected end of expression");
+        default:
+            return fail("Unexpected \"" + std::string(token.text) + "\"");
+        }
+    }
+
+    bool parseName(std::string_view text)
+    {
+        const std::string name = Lowered( text );
+
+        if ( (name == "mem") || (name == "word") )
+        {
+            return expect(Token::LeftBracket, "\"[\"") &&
+                   parseBinary(0) &&
+                   expect(Token::RightBracket, "\"]\"") &&
+                   append( (name == "mem") ? BreakpointCondition::LoadByte : BreakpointCondition::LoadWord );
+        }
+
+        if ( name == "a" )  return append(BreakpointCondition::PushA);
+        if ( name == "x" )  return append(BreakpointCondition::PushX);
+        if ( name == "y" )  return append(BreakpointCondition::PushY);
+        if ( name == "sp" ) return append(BreakpointCondition::PushSP);
+        if ( name == "pc" ) return append(BreakpointCondition::PushPC);
+        if ( (name == "p") || (name == "st") ) return append(BreakpointCondition::PushStatus);
+
+        if ( name.size() == 1 )
+        {
+            static constexpr std::string_view FlagNames = "nvbdizc";
+            static constexpr FLAGS6502        Flags[] = { N, V, B, D, I, Z, C };
+
+            if ( auto position = FlagNames.find( name[0] ); position != std::string_view::npos )
+                return append(BreakpointCondition::PushFlag, Flags[position]);
+        }
+
+        return fail("Unknown name \"" + std::string(text) + "\"");
+    }
+};
+
+std::optional<BreakpointCondition> BreakpointCondition::Compile(std::string_view expression, std::string *error_message)
+{
+    BreakpointCondition          condition;
+    BreakpointConditionCompiler  compiler( expression, condition );
+
+    if ( !compiler.compile() )
+    {
+        if ( error_message )
+            *error_message = compiler.error();
+        return std::nullopt;
+    }
+
+    condition._expression = std::string( TrimWhitespace(expression) );
+    condition._code.shrink_to_fit();
+    return condition;
+}
+
+namespace
+{
+
+// Whether dividend / divisor can be done as it is.  Dividing by zero and
+// INT32_MIN / -1 (which would overflow) can't.
+bool DividesCleanly(BreakpointCondition::valueType dividend, BreakpointCondition::valueType divisor)
+{
+    return (divisor != 0) && !((dividend == INT32_MIN) && (divisor == -1));
+}
+
+// What dividend / divisor gives when it can't be done: zero for a division
+// by zero, and INT32_MIN / -1 wraps around to INT32_MIN like the other operators
+BreakpointCondition::valueType Wrapped(BreakpointCondition::valueType dividend, BreakpointCondition::valueType divisor)
+{
+    return (divisor == 0) ? 0 : dividend;
+}
+
+}
+
+template <typename ReadByte>
+auto BreakpointCondition::run(const Registers &registers, ReadByte read_byte) const -> valueType
+{
+    valueType stack[MaxStackDepth];
+    valueType *top = stack - 1; // Points at the top-most value
+    const Instruction *code = _code.data();
+    const size_t       size = _code.size();
+
+    for (size_t pc = 0; pc < size; ++pc)
+    {
+        const Instruction &instruction = code[pc];
+
+        switch (instruction.op)
+        {
+        case PushConstant: *++top = instruction.operand; break;
+        case PushA:        *++top = registers.a; break;
+        case PushX:        *++top = registers.x; break;
+        case PushY:        *++top = registers.y; break;
+        case PushSP:       *++top = registers.stack_pointer; break;
+        case PushPC:       *++top = registers.program_counter; break;
+        case PushStatus:   *++top = registers.status; break;
+        case PushFlag:     *++top = (registers.status & instruction.operand) ? 1 : 0; break;
+        case LoadByte:
+            *top = read_byte( static_cast<uint16_t>(*top) );
+            break;
+        case LoadWord:
+            *top = read_byte( static_cast<uint16_t>(*top) ) |
+                   (read_byte( static_cast<uint16_t>(static_cast<uint16_t>(*top) + 1) ) << 8);
+            break;
+        case Negate:       *top = static_cast<valueType>(0u - static_cast<uint32_t>(*top)); break;
+        case Complement:   *top = ~*top; break;
+        case Not:          *top = !*top; break;
+        case ToBool:       *top = (*top != 0); break;
+        case Multiply:     top[-1] = static_cast<valueType>(static_cast<uint32_t>(top[-1]) * static_cast<uint32_t>(top[0])); --top; break;
+        case Divide:       top[-1] = DividesCleanly(top[-1], top[0]) ? top[-1] / top[0] : Wrapped(top[-1], top[0]); --top; break;
+        case Modulo:       top[-1] = DividesCleanly(top[-1], top[0]) ? top[-1] % top[0] : 0; --top; break;
+        case Add:          top[-1] = static_cast<valueType>(static_cast<uint32_t>(top[-1]) + static_cast<uint32_t>(top[0])); --top; break;
+        case Subtract:     top[-1] = static_cast<valueType>(static_cast<uint32_t>(top[-1]) - static_cast<uint32_t>(top[0])); --top; break;
+        case ShiftLeft:    top[-1] = static_cast<valueType>(static_cast<uint32_t>(top[-1]) << (top[0] & 31)); --top; break;
+        case ShiftRight:   top[-1] >>= (top[0] & 31); --top; break;
+        case Less:         top[-1] = top[-1] <  top[0]; --top; break;
+        case LessEqual:    top[-1] = top[-1] <= top[0]; --top; break;
+        case Greater:      top[-1] = top[-1] >  top[0]; --top; break;
+        case GreaterEqual: top[-1] = top[-1] >= top[0]; --top; break;
+        case Equal:        top[-1] = top[-1] == top[0]; --top; break;
+        case NotEqual:     top[-1] = top[-1] != top[0]; --top; break;
+        case BitAnd:       top[-1] &= top[0]; --top; break;
+        case BitXor:       top[-1] ^= top[0]; --top; break;
+        case BitOr:        top[-1] |= top[0]; --top; break;
+        case AndJump:
+            if ( *top == 0 )
+                pc = instruction.operand - 1;
+            else
+                --top;
+            break;
+        case OrJump:
+            if ( *top != 0 )
+            {
+                *top = 1;
+                pc = instruction.operand - 1;
+            }
+            else
+                --top;
+            break;
+        }
+    }
+
+    return *top;
+}
+
+auto BreakpointCondition::value(const Registers &registers, const memoryType &memory) const -> valueType
+{
+    return run( registers, [&memory](uint16_t address) { return memory[address]; } );
+}
+
+auto BreakpointCondition::value(const Registers &registers, const readDelegate &read_memory) const -> valueType
+{
+    return run( registers, read_memory );
+}
@@ -0,0 +1,104 @@
+#ifndef BREAKPOINTCONDITION_HPP
+#define BREAKPOINTCONDITION_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "registers.hpp"
+
+
+/** A condition attached to a breakpoint, such as "A == $FF && mem[$10] > 3".
+ *
+ *  The expression is parsed once by @c Compile() into a small stack-based
+ *  bytecode, so that evaluating it when the breakpoint is hit is only a
+ *  short loop over a handful of instructions.
+ *
+ *  The language:
+ *    - Numbers: decimal (16), hexadecimal ($10 or 0x10) and binary (%10000)
+ *    - Registers: A, X, Y, SP, PC, P (the status register, ST also works)
+ *    - Flags, as 0 or 1: N, V, B, D, I, Z, C
+ *    - Memory: mem[address] for a byte, word[address] for a little-endian word
+ *    - Operators, with C precedence: || && | ^ & == != < <= > >= << >> + - * / %
+ *      and the unary ! - ~
+ *
+ *  Names are not case-sensitive.  Arithmetic is done on 32-bit signed values
+ *  that wrap around on overflow, and a division by zero yields zero.
+ */
+class BreakpointCondition
+{
+public:
+    using valueType  = int32_t;
+    using memoryType = std::array<uint8_t, 64 * 1024>;
+    using readDelegate = std::function<uint8_t (uint16_t address)>;
+
+    static constexpr size_t MaxStackDepth = 32;
+
+    /** Parses and compiles an expression.
+     *
+     *  @param expression    The text of the condition
+     *  @param error_message If not nullptr, receives a description of why the
+     *                       expression could not be compiled
+     *
+     *  @return The compiled condition, or nothing if there was an error
+     */
+    static std::optional<BreakpointCondition> Compile(std::string_view expression, std::string *error_message = nullptr);
+
+    /** Evaluates the condition against the current state of the machine.
+     *
+     *  @return The value of the expression
+     */
+    valueType value(const Registers &registers, const memoryType &memory) const;
+
+    /** The same, but reading memory through @p read_memory, such as from a bus with devices mapped on it.
+     *
+     *  @p read_memory must not have side effects, as a device register being read would.
+     */
+    valueType value(const Registers &registers, const readDelegate &read_memory) const;
+
+    bool evaluate(const Registers &registers, const memoryType &memory) const { return value(registers, memory) != 0; }
+    bool evaluate(const Registers &registers, const readDelegate &read_memory) const { return value(registers, read_memory) != 0; }
+
+    const std::string &expression() const { return _expression; }
+
+    size_t instructionCount() const { return _code.size(); }
+
+protected:
+    friend class BreakpointConditionCompiler;
+
+    enum OpCode : uint8_t
+    {
+        PushConstant,
+        PushA, PushX, PushY, PushSP, PushPC, PushStatus,
+        PushFlag,     // operand is the FLAGS6502 mask
+        LoadByte,     // replaces the address on the top of the stack with mem[address]
+        LoadWord,
+        Negate, Complement, Not,
+        Multiply, Divide, Modulo,
+        Add, Subtract,
+        ShiftLeft, ShiftRight,
+        Less, LessEqual, Greater, GreaterEqual,
+        Equal, NotEqual,
+        BitAnd, BitXor, BitOr,
+        ToBool,
+        AndJump,      // if the top is 0, jump to operand leaving 0; otherwise pop it
+        OrJump        // if the top is not 0, jump to operand leaving 1; otherwise pop it
+    };
+
+    struct Instruction
+    {
+        OpCode    op;
+        valueType operand;
+    };
+
+    std::vector<Instruction> _code;
+    std::string              _expression;
+
+    template <typename ReadByte>
+    valueType run(const Registers &registers, ReadByte read_byte) const;
+};
+
+#endif // BREAKPOINTCONDITION_HPP
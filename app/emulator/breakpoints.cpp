@@ -0,0 +1,27 @@
+#include "breakpoints.hpp"
+
+
+void Breakpoints::set(Kind kind, addressType address, bool enabled)
+{
+    if ( test(kind, address) == enabled )
+        return;
+
+    _bits[kind][address] = enabled;
+    if ( enabled )
+        ++_counts[kind];
+    else
+        --_counts[kind];
+}
+
+void Breakpoints::clear(Kind kind)
+{
+    _bits[kind].reset();
+    _counts[kind] = 0;
+}
+
+void Breakpoints::clearAll()
+{
+    for (int kind = 0; kind < KindCount; ++kind)
+        clear( static_cast<Kind>(kind) );
+    acknowledge();
+}
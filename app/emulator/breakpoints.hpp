@@ -0,0 +1,72 @@
+#ifndef BREAKPOINTS_HPP
+#define BREAKPOINTS_HPP
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstddef>
+
+
+/** Execute breakpoints and read/write watchpoints for the 64KB address space.
+ *
+ *  Each kind is a 64K-bit bitmap, so testing an address is a single bit test.
+ *  A count of the set bits is kept so the run loop can skip testing entirely
+ *  when nothing of a kind is set.
+ */
+class Breakpoints
+{
+public:
+    using addressType = uint16_t;
+
+    enum Kind
+    {
+        Execute, ///< Stop before executing the instruction at the address
+        Read,    ///< Stop after the address is read as data
+        Write,   ///< Stop after the address is written
+        KindCount
+    };
+
+    /** Describes the watchpoint that was triggered.
+     *
+     *  @note Only Read and Write watchpoints are recorded here.  Execute
+     *        breakpoints are tested by the run loop itself.
+     */
+    struct Hit
+    {
+        bool        triggered = false;
+        Kind        kind = Read;
+        addressType address = 0;
+    };
+
+    bool test(Kind kind, addressType address) const { return _bits[kind][address]; }
+
+    void set(Kind kind, addressType address, bool enabled);
+    void toggle(Kind kind, addressType address) { set( kind, address, !test(kind, address) ); }
+
+    void clear(Kind kind);
+    void clearAll();
+
+    size_t count(Kind kind) const { return _counts[kind]; }
+    bool   any(Kind kind) const { return _counts[kind] != 0; }
+    bool   anyWatchpoints() const { return any(Read) || any(Write); }
+
+    /** Records that a watchpoint was triggered.
+     *
+     *  Only the first one is kept until @c acknowledge() is called.
+     */
+    void trigger(Kind kind, addressType address)
+    {
+        if ( !_hit.triggered )
+            _hit = Hit{ true, kind, address };
+    }
+
+    const Hit &hit() const { return _hit; }
+    void acknowledge() { _hit = Hit{}; }
+
+protected:
+    std::array<std::bitset<64 * 1024>, KindCount> _bits;
+    std::array<size_t, KindCount>                 _counts{};
+    Hit                                           _hit;
+};
+
+#endif // BREAKPOINTS_HPP
@@ -1,4 +1,8 @@
 #include "bus.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
 
 Bus::Bus(QObject *parent)
     :
@@ -6,12 +10,192 @@ Bus::Bus(QObject *parent)
 {
 }
 
-void Bus::write(addressType address, uint8_t data)
+Bus::~Bus()
+{
+}
+
+bool Bus::map(IBusDevice *device, std::string *error_message, IBusDevice *underneath)
 {
-    emit busWritten(address, data);
+    const uint32_t first = device->lowerAddress();
+    const uint32_t last  = device->upperAddress();
+
+    for (uint32_t address = first; address <= last; ++address)
+    {
+        const IBusDevice *mapped = deviceAt( static_cast<addressType>(address) );
+
+        if ( mapped && (mapped != underneath) )
+        {
+            if ( error_message )
+            {
+                char buffer[96];
+
+                snprintf( buffer, sizeof(buffer), "$%04X-$%04X overlaps the device at $%04X-$%04X from $%04X",
+                          unsigned(first), unsigned(last),
+                          unsigned(mapped->lowerAddress()), unsigned(mapped->upperAddress()), unsigned(address) );
+                *error_message = buffer;
+            }
+            return false;
+        }
+    }
+
+    for (uint32_t address = first; address <= last; ++address)
+    {
+        // Whole pages go straight in the table
+        if ( ((address & 0xFF) == 0) && (last - address >= 0xFF) )
+        {
+            Page &page = _pages[address >> 8];
+
+            page.sub_page.reset();
+            page.device = device;
+            address += 0xFF;
+            continue;
+        }
+        setDevice( static_cast<addressType>(address), device );
+    }
+
+    for (Page &iCurrentPage : _pages)
+        mergeSubPage( iCurrentPage );
+    _underneath[device] = underneath;
+    return true;
 }
 
-uint8_t Bus::read(addressType address, bool read_only)
+void Bus::unmap(IBusDevice *device)
 {
-    return emit busRead(address, read_only);
+    IBusDevice *underneath = nullptr;
+
+    if ( auto found = _underneath.find( device ); found != _underneath.end() )
+    {
+        underneath = found->second;
+        _underneath.erase( found );
+    }
+
+    for (Page &iCurrentPage : _pages)
+    {
+        if ( iCurrentPage.sub_page )
+        {
+            std::replace( iCurrentPage.sub_page->begin(), iCurrentPage.sub_page->end(), device, underneath );
+            mergeSubPage( iCurrentPage );
+        }
+        else if ( iCurrentPage.device == device )
+        {
+            iCurrentPage.device = underneath;
+        }
+    }
+}
+
+bool Bus::mappedTo(addressType first, addressType last, const IBusDevice *device) const
+{
+    for (uint32_t address = first; address <= last; ++address)
+    {
+        if ( deviceAt( static_cast<addressType>(address) ) != device )
+            return false;
+    }
+    return true;
+}
+
+void Bus::setDevice(addressType address, IBusDevice *device)
+{
+    Page &page = _pages[address >> 8];
+
+    if ( !page.sub_page )
+    {
+        page.sub_page = std::make_unique<SubPage>();
+        page.sub_page->fill( page.device );
+        page.device = nullptr;
+    }
+    (*page.sub_page)[address & 0xFF] = device;
+}
+
+void Bus::mergeSubPage(Page &page)
+{
+    // A page that has ended up with a single device needs no table of its own
+    if ( page.sub_page &&
+         std::all_of( page.sub_page->begin(), page.sub_page->end(),
+                      [&page](const IBusDevice *device) { return device == page.sub_page->front(); } ) )
+    {
+        page.device = page.sub_page->front();
+        page.sub_page.reset();
+    }
+}
+
+template <typename Action>
+void Bus::forEachRun(addressType address, size_t size, Action action) const
+{
+    // Blocks stop at the end of the address space, as they do on the devices
+    size_t remaining = std::min<size_t>( size, 0x10000 - size_t(address) );
+    uint32_t first = address;
+
+    while ( remaining > 0 )
+    {
+        IBusDevice *device = deviceAt( static_cast<addressType>(first) );
+        size_t      length = 0;
+
+        while ( length < remaining )
+        {
+            const uint32_t next = first + length;
+            const Page    &page = _pages[next >> 8];
+
+            if ( !page.sub_page && (page.device == device) )
+                length += 0x100 - (next & 0xFF); // The rest of the page
+            else if ( page.sub_page && ((*page.sub_page)[next & 0xFF] == device) )
+                ++length;
+            else
+                break;
+        }
+        length = std::min( length, remaining );
+
+        action( device, static_cast<addressType>(first), length );
+        first += static_cast<uint32_t>(length);
+        remaining -= length;
+    }
+}
+
+void Bus::readBlock(addressType address, uint8_t *data, size_t size, bool read_only)
+{
+    std::fill_n( data, size, 0x00 );
+    forEachRun( address, size, [=](IBusDevice *device, addressType first, size_t length)
+    {
+        if ( device )
+            device->readBlock( first, data + (first - address), length, read_only );
+    });
+}
+
+void Bus::writeBlock(addressType address, const uint8_t *data, size_t size)
+{
+    forEachRun( address, size, [=](IBusDevice *device, addressType first, size_t length)
+    {
+        if ( device )
+            device->writeBlock( first, data + (first - address), length );
+    });
+}
+
+void Bus::fill(addressType address, size_t size, uint8_t value)
+{
+    forEachRun( address, size, [=](IBusDevice *device, addressType first, size_t length)
+    {
+        if ( device )
+            device->fill( first, length, value );
+    });
+}
+
+void Bus::copy(addressType destination, addressType source, size_t size)
+{
+    if ( size == 0 )
+        return;
+
+    IBusDevice *device = deviceAt( source );
+    const addressType first = std::min( source, destination );
+    const addressType last  = static_cast<addressType>( std::min<size_t>( size_t( std::max( source, destination ) ) + size - 1, 0xFFFF ) );
+
+    // Within one device it can be done in place
+    if ( device && mappedTo( first, last, device ) )
+    {
+        device->copy( destination, source, size );
+        return;
+    }
+
+    std::vector<uint8_t> buffer( size );
+
+    readBlock( source, buffer.data(), size, false );
+    writeBlock( destination, buffer.data(), size );
 }
@@ -2,9 +2,26 @@
 #define BUS_HPP
 
 #include <QObject>
+#include <array>
+#include <map>
 #include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "ibusdevice.hpp"
 
 
+/** Connects the CPU to the devices mapped into its address space.
+ *
+ *  Each address belongs to at most one device, found through a table with
+ *  an entry for each page.  Devices covering whole pages are in the table
+ *  itself; a page shared between devices (typically I/O registers) gets a
+ *  table of its own with an entry for each address.  Either way an access is
+ *  one or two lookups, whatever the number of devices.
+ *
+ *  Reading an address no device is mapped at gives 0, and writing to one
+ *  does nothing.
+ */
 class Bus : public QObject
 {
     Q_OBJECT
@@ -12,18 +29,84 @@ public:
     using addressType = uint16_t;
 
     explicit Bus(QObject *parent = nullptr);
+   ~Bus() override;
 
     static constexpr addressType bitWidth()   { return 16; }
     static constexpr addressType minAddress() { return 0x00; }
     static constexpr addressType maxAddress() { return static_cast<addressType>(1 << (bitWidth() - 1)); }
 
+    /** Maps a device at its range of addresses.
+     *
+     *  @param device        The device to map.  It must outlive the mapping.
+     *  @param error_message If not nullptr, receives a description of why the
+     *                       device could not be mapped
+     *  @param underneath    A device that gives way where the two overlap, such
+     *                       as RAM filling the address space, or nullptr
+     *
+     *  @return true if it was mapped, false if it overlaps another device (and nothing was changed)
+     */
+    bool map(IBusDevice *device, std::string *error_message = nullptr, IBusDevice *underneath = nullptr);
+
+    /// Unmaps a device from wherever it is mapped, putting back the device it was mapped over, if any.
+    void unmap(IBusDevice *device);
+
+    /// The device mapped at an address, or nullptr if there is none
+    IBusDevice *deviceAt(addressType address) const
+    {
+        const Page &page = _pages[address >> 8];
+
+        return page.sub_page ? (*page.sub_page)[address & 0xFF] : page.device;
+    }
+
+    /// Tells whether every address from @p first to @p last is mapped to @p device.
+    bool mappedTo(addressType first, addressType last, const IBusDevice *device) const;
+
+    /** @name Blocks
+     *  As IBusDevice's, with the block split between whichever devices its
+     *  addresses are mapped to.
+     */
+    ///@{
+    void readBlock(addressType address, uint8_t *data, size_t size, bool read_only);
+    void writeBlock(addressType address, const uint8_t *data, size_t size);
+    void fill(addressType address, size_t size, uint8_t value);
+    void copy(addressType destination, addressType source, size_t size);
+    ///@}
+
 public slots:
-    void    write(addressType address, uint8_t data);
-    uint8_t read(addressType address, bool read_only);
+    void    write(addressType address, uint8_t data)
+    {
+        if ( IBusDevice *device = deviceAt( address ) )
+            device->write( address, data );
+    }
+
+    uint8_t read(addressType address, bool read_only)
+    {
+        IBusDevice *device = deviceAt( address );
+
+        return device ? device->read( address, read_only ) : 0x00;
+    }
+
+protected:
+    using SubPage = std::array<IBusDevice *, 256>;
+
+    struct Page
+    {
+        IBusDevice              *device = nullptr;  ///< The device of the whole page, when there is no sub_page
+        std::unique_ptr<SubPage> sub_page;
+    };
+
+    std::array<Page, 256> _pages;
+    std::map<const IBusDevice *, IBusDevice *> _underneath; ///< What each device was mapped over
+
+    void setDevice(addressType address, IBusDevice *device);
+    void mergeSubPage(Page &page);
 
-signals:
-    void    busWritten(addressType address, uint8_t data);
-    uint8_t busRead(addressType address, bool read_only);
+    /** Calls @p action for each run of consecutive addresses mapped to the same device.
+     *
+     *  @param action Called with the device (possibly nullptr), the first address of the run and its length
+     */
+    template <typename Action>
+    void forEachRun(addressType address, size_t size, Action action) const;
 };
 
 #endif // BUS_HPP
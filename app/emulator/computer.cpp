@@ -1,29 +1,45 @@
 #include "computer.hpp"
 #include <QTimer>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
 
 #include "io/io.hpp"
+#include "statehash.hpp"
 
 
+static constexpr uint8_t JSROpcode = 0x20;
+static constexpr uint8_t RTIOpcode = 0x40;
+static constexpr uint8_t RTSOpcode = 0x60;
+
 Computer::Computer(QObject *parent) : QObject(parent)
 {
+    // The bus is always called directly, even when the CPU is run from the
+    // emulation thread.  Queueing the calls would lose the values read.
+
     // Read signals
     QObject::connect(&_cpu, &olc6502::readSignal,
-                     &_bus, &Bus::read);
-    QObject::connect(&_bus,    &Bus::busRead,
-                     &_memory, &RamBusDevice::read);
+                     &_bus, &Bus::read, Qt::DirectConnection);
 
     // Write signals
     QObject::connect(&_cpu, &olc6502::writeSignal,
-                     &_bus, &Bus::write);
-    QObject::connect(&_bus,    &Bus::busWritten,
-                     &_memory, &RamBusDevice::write);
+                     &_bus, &Bus::write, Qt::DirectConnection);
+
+    // RAM fills the address space, except where other devices are mapped
+    _bus.map( &_memory );
+    setDirectPagesEnabled( true );
     _clock.setInterval(16);
     _clock.setSingleShot(false);
     QObject::connect(&_clock, &QTimer::timeout,
                      this,    &Computer::timerTimeout);
 }
 
+void Computer::setChangeSignalsEnabled(bool enabled)
+{
+    _cpu.setChangeSignalsEnabled( enabled );
+    _memory.blockSignals( !enabled );
+}
+
 void Computer::startClock()
 {
     _clock.start();
@@ -49,20 +65,248 @@ void Computer::stepInstruction(int number_of_instructions)
     }
 }
 
+Computer::StopReason Computer::run(uint32_t cycles)
+{
+    _breakpoints.acknowledge();
+    _cpu.acknowledgeBrk();
+
+    if ( _run_target == RunTarget::Cycles )
+    {
+        // Shorten the batch so it ends on the target tick
+        cycles = static_cast<uint32_t>( std::min<uint64_t>( cycles, _target_clock_ticks - _cpu.clockTicks() ) );
+    }
+
+    if ( (_run_target == RunTarget::None || _run_target == RunTarget::Cycles) &&
+         !_breakpoints.any(Breakpoints::Execute) && !_breakpoints.anyWatchpoints() )
+    {
+        for ( ; cycles > 0; --cycles )
+        {
+            _cpu.clock();
+
+            // Let the BRK finish, so it stops at the start of the handler
+            if ( _cpu.brkExecuted() && _cpu.complete() )
+                return finishRun( StopReason::Brk );
+        }
+        return finishRun( StopReason::Completed );
+    }
+
+    for ( ; cycles > 0; --cycles )
+    {
+        _cpu.clock();
+
+        if ( _breakpoints.hit().triggered )
+            return finishRun( StopReason::Watchpoint );
+
+        if ( !_cpu.complete() )
+            continue;
+
+        if ( _cpu.brkExecuted() )
+            return finishRun( StopReason::Brk );
+
+        if ( runTargetReached() )
+            return finishRun( StopReason::Target );
+
+        if ( _breakpoints.test(Breakpoints::Execute, _cpu.pc()) && breakpointConditionHolds( _cpu.pc() ) )
+            return finishRun( StopReason::Breakpoint );
+    }
+    return finishRun( StopReason::Completed );
+}
+
+Computer::StopReason Computer::finishRun(StopReason reason)
+{
+    if ( statisticsEnabled() )
+    {
+        SessionStatistics::Set( _statistics->cycles, _cpu.clockTicks() );
+        SessionStatistics::Set( _statistics->instructions, _cpu.instructionCount() );
+        if ( reason == StopReason::Breakpoint )
+            SessionStatistics::Increment( _statistics->breakpoints_hit );
+        else if ( reason == StopReason::Watchpoint )
+            SessionStatistics::Increment( _statistics->watchpoints_hit );
+    }
+
+    if ( (reason == StopReason::Completed) && (_run_target == RunTarget::Cycles) &&
+         (_cpu.clockTicks() == _target_clock_ticks) )
+        reason = StopReason::Target;
+
+    if ( reason != StopReason::Completed )
+        cancelRunTarget();
+    return reason;
+}
+
+void Computer::stepOver()
+{
+    if ( _cpu.read( _cpu.pc(), true ) == JSROpcode )
+    {
+        _run_target = RunTarget::StepOver;
+        _target_stack_pointer = _cpu.stackPointer();
+    }
+    else
+    {
+        _run_target = RunTarget::NextInstruction;
+    }
+}
+
+void Computer::stepOut()
+{
+    _run_target = RunTarget::StepOut;
+    _target_stack_pointer = _cpu.stackPointer();
+}
+
+void Computer::runTo(olc6502::addressType address)
+{
+    _run_target = RunTarget::Address;
+    _target_address = address;
+}
+
+void Computer::runCycles(uint32_t cycles)
+{
+    _run_target = RunTarget::Cycles;
+    _target_clock_ticks = _cpu.clockTicks() + cycles;
+}
+
+bool Computer::runTargetReached() const
+{
+    // The stack grows down and wraps within page 1, so compare the distance
+    // from the saved level rather than the raw values
+    const int8_t stack_level = static_cast<int8_t>( _cpu.stackPointer() - _target_stack_pointer );
+
+    switch ( _run_target )
+    {
+    case RunTarget::NextInstruction:
+        return true;
+    case RunTarget::StepOver:
+        return stack_level >= 0;
+    case RunTarget::StepOut:
+        return ((_cpu.opcode() == RTSOpcode) || (_cpu.opcode() == RTIOpcode)) && (stack_level > 0);
+    case RunTarget::Address:
+        return _cpu.pc() == _target_address;
+    default:
+        break;
+    }
+    return false;
+}
+
+void Computer::setBreakpoint(Breakpoints::Kind kind, Breakpoints::addressType address, bool enabled)
+{
+    _breakpoints.set( kind, address, enabled );
+    if ( (kind == Breakpoints::Execute) && !enabled )
+        _breakpoint_conditions.erase( address );
+    armWatchpoints();
+}
+
+void Computer::toggleBreakpoint(Breakpoints::Kind kind, Breakpoints::addressType address)
+{
+    _breakpoints.toggle( kind, address );
+    if ( (kind == Breakpoints::Execute) && !_breakpoints.test(kind, address) )
+        _breakpoint_conditions.erase( address );
+    armWatchpoints();
+}
+
+void Computer::clearBreakpoints()
+{
+    _breakpoints.clearAll();
+    _breakpoint_conditions.clear();
+    armWatchpoints();
+}
+
+void Computer::setBreakpointCondition(Breakpoints::addressType address, std::optional<BreakpointCondition> condition)
+{
+    _breakpoints.set( Breakpoints::Execute, address, true );
+
+    if ( condition )
+        _breakpoint_conditions.insert_or_assign( address, std::move(condition.value()) );
+    else
+        _breakpoint_conditions.erase( address );
+}
+
+const BreakpointCondition *Computer::breakpointCondition(Breakpoints::addressType address) const
+{
+    auto found = _breakpoint_conditions.find( address );
+
+    return (found == _breakpoint_conditions.end()) ? nullptr : &found->second;
+}
+
+bool Computer::breakpointConditionHolds(Breakpoints::addressType address) const
+{
+    if ( _breakpoint_conditions.empty() )
+        return true;
+
+    auto found = _breakpoint_conditions.find( address );
+
+    if ( found == _breakpoint_conditions.end() )
+        return true;
+
+    // Through the bus, so that mem[] sees mapped devices as the CPU does, but read-only
+    return found->second.evaluate( _cpu.registers(), [this](uint16_t address) -> uint8_t
+    {
+        IBusDevice *device = _bus.deviceAt( address );
+
+        return device ? device->read( address, true ) : 0x00;
+    });
+}
+
+void Computer::armWatchpoints()
+{
+    // The CPU only tests accesses against the bitmaps while there is something to find
+    _cpu.setWatchpoints( _breakpoints.anyWatchpoints() ? &_breakpoints : nullptr );
+}
+
 void Computer::timerTimeout()
 {
     stepClock();
 }
 
-void Computer::load(const MemoryBlock &mb)
+uint64_t Computer::stateHash() const
+{
+    const RamBusDevice::memory_type &memory = _memory.memory();
+
+    return HashBytes( memory.data(), memory.size(), _cpu.stateHash() );
+}
+
+bool Computer::mapDevice(IBusDevice *device, std::string *error_message)
+{
+    if ( !_bus.map( device, error_message, &_memory ) )
+        return false;
+
+    updateDirectPages();
+    return true;
+}
+
+void Computer::unmapDevice(IBusDevice *device)
+{
+    _bus.unmap( device );
+    updateDirectPages();
+}
+
+bool Computer::setDirectPagesEnabled(bool enabled, std::string *error_message)
+{
+    if ( enabled && !_bus.mappedTo( 0x0000, 0x01FF, &_memory ) )
+    {
+        if ( error_message )
+            *error_message = "A device is mapped in $0000-$01FF";
+        return false;
+    }
+
+    _direct_pages_wanted = enabled;
+    updateDirectPages();
+    return true;
+}
+
+void Computer::updateDirectPages()
 {
-    int start_address = mb.first;
+    // A device mapped there has to see the accesses made to it
+    if ( _direct_pages_wanted && _bus.mappedTo( 0x0000, 0x01FF, &_memory ) )
+        _cpu.setDirectPages( _memory.data(), _memory.dirtyPages( 0x0000 ) );
+    else
+        _cpu.setDirectPages( nullptr, nullptr );
+}
 
-    for (uint8_t iCurrentByte : mb.second)
-        _memory.write(start_address++, iCurrentByte);
+void Computer::load(const MemoryBlock &mb)
+{
+    writeBlock( static_cast<Bus::addressType>(mb.first), mb.second.data(), mb.second.size() );
 }
 
-void Computer::loadProgram(QString path)
+bool Computer::loadProgram(QString path)
 {
     OptionalProgram input = ReadFromFile( path );
 
@@ -85,4 +329,91 @@ void Computer::loadProgram(QString path)
         // Reset
         _cpu.reset();
     }
+    return input.has_value();
+}
+
+void Computer::setHeatmapEnabled(bool enabled)
+{
+    _cpu.setHeatmap( enabled ? _heatmap.get() : nullptr );
+}
+
+bool Computer::exportHeatmap(QString path) const
+{
+    std::ofstream output( path.toStdString() );
+
+    if ( !output )
+        return false;
+
+    _heatmap->exportTo( output );
+    return static_cast<bool>(output);
+}
+
+void Computer::setWriteProvenanceEnabled(bool enabled)
+{
+    _cpu.setWriteProvenance( enabled ? _write_provenance.get() : nullptr );
+}
+
+bool Computer::exportWriteProvenance(QString path) const
+{
+    std::ofstream output( path.toStdString() );
+
+    if ( !output )
+        return false;
+
+    _write_provenance->exportTo( output );
+    return static_cast<bool>(output);
+}
+
+void Computer::setProfileEnabled(bool enabled)
+{
+    _cpu.setProfile( enabled ? _profile.get() : nullptr );
+}
+
+void Computer::reportProfile(std::ostream &output) const
+{
+    _profile->exportTo( output,
+                        [this](uint8_t opcode)
+                        {
+                            return _cpu.mnemonic( opcode );
+                        },
+                        [this](uint8_t opcode)
+                        {
+                            return _cpu.addressingMode( opcode );
+                        });
+}
+
+bool Computer::exportProfile(QString path) const
+{
+    std::ofstream output( path.toStdString() );
+
+    if ( !output )
+        return false;
+
+    reportProfile( output );
+    return static_cast<bool>(output);
+}
+
+void Computer::setStatisticsEnabled(bool enabled)
+{
+    _cpu.setStatistics( enabled ? _statistics.get() : nullptr );
+}
+
+void Computer::dumpFlightRecorder(std::ostream &output) const
+{
+    _cpu.flightRecorder().exportTo( output,
+                                    [this](uint8_t opcode)
+                                    {
+                                        return _cpu.mnemonic( opcode );
+                                    });
+}
+
+bool Computer::exportFlightRecorder(QString path) const
+{
+    std::ofstream output( path.toStdString() );
+
+    if ( !output )
+        return false;
+
+    dumpFlightRecorder( output );
+    return static_cast<bool>(output);
 }
@@ -6,7 +6,16 @@
 #include "olc6502.hpp"
 #include "bus.hpp"
 #include "rambusdevice.hpp"
+#include "memoryheatmap.hpp"
+#include "breakpoints.hpp"
+#include "writeprovenance.hpp"
+#include "instructionprofile.hpp"
+#include "sessionstatistics.hpp"
+#include "breakpointcondition.hpp"
 #include "io/io.hpp"
+#include <memory>
+#include <optional>
+#include <unordered_map>
 
 
 class Computer : public QObject
@@ -16,9 +25,258 @@ class Computer : public QObject
     Q_PROPERTY(olc6502      *cpu READ cpu CONSTANT FINAL)
     Q_PROPERTY(RamBusDevice *ram READ ram CONSTANT FINAL)
 public:
+    enum class StopReason
+    {
+        Completed,  ///< All of the requested cycles were run
+        Breakpoint, ///< The next instruction is at an execute breakpoint
+        Watchpoint, ///< A watched address was read or written
+        Target,     ///< The run target was reached
+        Brk         ///< A BRK was executed while stopping on BRK is on
+    };
+
     explicit Computer(QObject *parent = nullptr);
 
-    void loadProgram(QString path);
+    /** Loads a program into memory and resets the CPU.
+     *
+     *  @param path The name of the file to load
+     *
+     *  @return true if the file could be read
+     */
+    bool loadProgram(QString path);
+
+    /** @name Memory blocks
+     *  Accesses a run of consecutive addresses at once, as the CPU would see
+     *  them but without the CPU taking part (so without counting any
+     *  accesses or stopping at watchpoints).
+     *
+     *  @see IBusDevice::readBlock
+     */
+    ///@{
+    void readBlock(Bus::addressType address, uint8_t *data, size_t size) { _bus.readBlock( address, data, size, true ); }
+    void writeBlock(Bus::addressType address, const uint8_t *data, size_t size) { _bus.writeBlock( address, data, size ); }
+    void fill(Bus::addressType address, size_t size, uint8_t value) { _bus.fill( address, size, value ); }
+    void copy(Bus::addressType destination, Bus::addressType source, size_t size) { _bus.copy( destination, source, size ); }
+    ///@}
+
+    /** Maps a device, such as a page of I/O registers, in place of RAM.
+     *
+     *  RAM is still there underneath, so @c ram() shows what was stored there
+     *  before, but the CPU only sees the device.  Mapping one anywhere in
+     *  $0000-$01FF turns off the direct pages.
+     *
+     *  @param device        The device to map.  It must outlive the computer.
+     *  @param error_message If not nullptr, receives why it could not be mapped
+     *
+     *  @return true if it was mapped, false if it overlaps another device
+     */
+    bool mapDevice(IBusDevice *device, std::string *error_message = nullptr);
+
+    /** Unmaps a device mapped by @c mapDevice(), so the CPU sees the RAM
+     *  underneath it again.  If mapping it turned off the direct pages, they
+     *  are turned back on.
+     */
+    void unmapDevice(IBusDevice *device);
+
+    /** Lets the CPU read and write the zero page and the stack ($0000-$01FF)
+     *  straight from RAM, instead of through the bus.  It is on from the start.
+     *
+     *  @param enabled       true to access them directly
+     *  @param error_message If not nullptr, receives why it could not be turned on
+     *
+     *  @return false if it can't be turned on because a device is mapped there
+     */
+    bool setDirectPagesEnabled(bool enabled, std::string *error_message = nullptr);
+    bool directPagesEnabled() const { return _cpu.directPages(); }
+
+    const Bus *bus() const { return &_bus; }
+
+    /** Turns the collection of per-byte access counters on or off.
+     *
+     *  The counters keep their values while collection is off.
+     *
+     *  @param enabled true to count every access the CPU makes
+     */
+    void setHeatmapEnabled(bool enabled);
+    bool heatmapEnabled() const { return _cpu.heatmap() != nullptr; }
+
+    const MemoryHeatmap *heatmap() const { return _heatmap.get(); }
+    void clearHeatmap() { _heatmap->clear(); }
+
+    /** Writes the access counters to a CSV file.
+     *
+     *  @param path The name of the file to create
+     *
+     *  @return true if the file was written
+     */
+    bool exportHeatmap(QString path) const;
+
+    /** Turns the recording of who last wrote each byte on or off.
+     *
+     *  What was recorded is kept while recording is off.
+     *
+     *  @param enabled true to record the instruction and cycle of every write the CPU makes
+     */
+    void setWriteProvenanceEnabled(bool enabled);
+    bool writeProvenanceEnabled() const { return _cpu.writeProvenance() != nullptr; }
+
+    const WriteProvenance *writeProvenance() const { return _write_provenance.get(); }
+    void clearWriteProvenance() { _write_provenance->clear(); }
+
+    /** Writes the last writer of every address to a CSV file.
+     *
+     *  @param path The name of the file to create
+     *
+     *  @return true if the file was written
+     */
+    bool exportWriteProvenance(QString path) const;
+
+    /** Turns the counting of executed instructions and their penalty cycles on or off.
+     *
+     *  The counters keep their values while counting is off.
+     *
+     *  @param enabled true to count every instruction executed
+     */
+    void setProfileEnabled(bool enabled);
+    bool profileEnabled() const { return _cpu.profile() != nullptr; }
+
+    const InstructionProfile *profile() const { return _profile.get(); }
+    void clearProfile() { _profile->clear(); }
+
+    /** Writes the instruction mix and penalty report.
+     *
+     *  @param output The stream to write to
+     */
+    void reportProfile(std::ostream &output) const;
+
+    /** Writes the instruction mix and penalty report to a file.
+     *
+     *  @param path The name of the file to create
+     *
+     *  @return true if the file was written
+     */
+    bool exportProfile(QString path) const;
+
+    /** Turns the session statistics on or off.
+     *
+     *  While they are on, the counters are brought up to date at the end of
+     *  every @c run() and can be read from another thread at any time.
+     *
+     *  @param enabled true to keep the statistics
+     */
+    void setStatisticsEnabled(bool enabled);
+    bool statisticsEnabled() const { return _cpu.statistics() != nullptr; }
+
+    const SessionStatistics &statistics() const { return *_statistics; }
+
+    /** Hashes the whole state of the machine: the registers, the instruction in
+     *  progress, the clock and all of memory.
+     *
+     *  Two runs that end with the same hash ended in the same state, so this is
+     *  a cheap way to check that a replay or another backend is deterministic.
+     *  It takes a few microseconds.
+     */
+    uint64_t stateHash() const;
+
+    /** Writes the flight recorder, the most recently executed instructions, as text.
+     *
+     *  @param output The stream to write to
+     */
+    void dumpFlightRecorder(std::ostream &output) const;
+
+    /** Writes the flight recorder to a file.
+     *
+     *  @param path The name of the file to create
+     *
+     *  @return true if the file was written
+     */
+    bool exportFlightRecorder(QString path) const;
+
+    /** Runs a batch of clock cycles, stopping early for breakpoints.
+     *
+     *  When no breakpoints or watchpoints are set, this is a plain loop
+     *  around the CPU's clock, which also stops after a BRK when
+     *  @c setStopOnBrk() is on.  Execute breakpoints are only tested at
+     *  instruction boundaries, and not before the first instruction, so
+     *  calling this again continues past the breakpoint that stopped it.
+     *
+     *  @param cycles The maximum number of clock cycles to run
+     *
+     *  @return Why the batch stopped
+     *
+     *  @see breakpoints
+     */
+    StopReason run(uint32_t cycles);
+
+    /** Stops @c run() once a BRK has been executed, at the start of its handler.
+     *
+     *  Unlike a breakpoint on the handler, this keeps @c run() on its plain
+     *  loop, so the run is as fast as without it.
+     */
+    void setStopOnBrk(bool stop) { _cpu.setStopOnBrk( stop ); }
+    bool stopOnBrk() const { return _cpu.stopOnBrk(); }
+
+    /** @name Run targets
+     *
+     *  A run target arms a stop condition that @c run() tests as it goes, so
+     *  reaching it takes as many batches as needed at full speed.  It is
+     *  disarmed when the target is reached, when the run stops for any other
+     *  reason, or by @c cancelRunTarget().
+     */
+    ///@{
+    /** Runs over the next instruction.
+     *
+     *  For a JSR this stops once the stack pointer is back at its level before
+     *  the call, which is after the subroutine has returned.  Any other
+     *  instruction stops after it is executed.
+     */
+    void stepOver();
+
+    /// Stops after an RTS or RTI that returns from the current stack level.
+    void stepOut();
+
+    /// Stops before executing the instruction at @p address.
+    void runTo(olc6502::addressType address);
+
+    /// Stops after @p cycles more clock cycles.
+    void runCycles(uint32_t cycles);
+
+    void cancelRunTarget() { _run_target = RunTarget::None; }
+    bool hasRunTarget() const { return _run_target != RunTarget::None; }
+    ///@}
+
+    /** Turns the signals of register and memory changes on or off.
+     *
+     *  They are turned off while the emulation thread is running the
+     *  computer.  The views are then drawn from its snapshots, and the
+     *  signals would otherwise be delivered on the wrong thread.  Reads
+     *  and writes over the bus carry on regardless.
+     *
+     *  @param enabled false to stop the CPU and memory signalling changes
+     */
+    void setChangeSignalsEnabled(bool enabled);
+
+    const Breakpoints &breakpoints() const { return _breakpoints; }
+    void setBreakpoint(Breakpoints::Kind kind, Breakpoints::addressType address, bool enabled);
+    void toggleBreakpoint(Breakpoints::Kind kind, Breakpoints::addressType address);
+    void clearBreakpoints();
+
+    /** Attaches a condition to the execute breakpoint at an address.
+     *
+     *  The breakpoint then only stops the run when the condition is true.
+     *  The condition is evaluated only when the address is reached, and is
+     *  removed along with the breakpoint.  Memory in the condition is read
+     *  through the bus, read-only, so mapped devices are seen but not disturbed.
+     *
+     *  @param address   The address of the breakpoint.  It is set if it isn't already.
+     *  @param condition The compiled condition, or nothing to make the breakpoint unconditional
+     */
+    void setBreakpointCondition(Breakpoints::addressType address, std::optional<BreakpointCondition> condition);
+
+    /** Queries the condition attached to the breakpoint at an address.
+     *
+     *  @return The condition, or nullptr if there is none
+     */
+    const BreakpointCondition *breakpointCondition(Breakpoints::addressType address) const;
 
 public slots:
     void startClock();
@@ -43,8 +301,35 @@ private:
     Bus     _bus;
     RamBusDevice _memory;
     QTimer       _clock;
+    std::unique_ptr<MemoryHeatmap> _heatmap{ std::make_unique<MemoryHeatmap>() };
+    std::unique_ptr<WriteProvenance> _write_provenance{ std::make_unique<WriteProvenance>() };
+    std::unique_ptr<InstructionProfile> _profile{ std::make_unique<InstructionProfile>() };
+    std::unique_ptr<SessionStatistics>  _statistics{ std::make_unique<SessionStatistics>() };
+    Breakpoints  _breakpoints;
+    std::unordered_map<Breakpoints::addressType, BreakpointCondition> _breakpoint_conditions;
+    bool _direct_pages_wanted = true; ///< As last set by setDirectPagesEnabled(), whatever is mapped
+
+    enum class RunTarget
+    {
+        None,
+        NextInstruction,
+        StepOver,
+        StepOut,
+        Address,
+        Cycles
+    };
+
+    RunTarget            _run_target = RunTarget::None;
+    uint8_t              _target_stack_pointer = 0;
+    olc6502::addressType _target_address = 0;
+    uint64_t             _target_clock_ticks = 0;
 
     void load(const MemoryBlock &mb);
+    void armWatchpoints();
+    void updateDirectPages();
+    bool breakpointConditionHolds(Breakpoints::addressType address) const;
+    bool runTargetReached() const;
+    StopReason finishRun(StopReason reason);
 
     Q_DISABLE_COPY(Computer)
 };
@@ -0,0 +1,51 @@
+#include "cpubackend.hpp"
+
+
+std::unique_ptr<CpuBackend> CpuBackend::Create(std::string_view name)
+{
+    if ( name == "reference" )
+        return std::make_unique<ReferenceBackend>();
+    return nullptr;
+}
+
+ReferenceBackend::ReferenceBackend()
+    :
+    _executor( _registers,
+               [this](InstructionExecutor::addressType address, bool) { return _memory[address]; },
+               [this](InstructionExecutor::addressType address, uint8_t data)
+               {
+                   _memory[address] = data;
+                   _write_hash = HashWrite( _write_hash, address, data );
+               },
+               [](uint8_t) {}, [](uint8_t) {}, [](uint8_t) {},
+               [](uint16_t) {},
+               [](uint8_t) {}, [](uint8_t) {} )
+{
+}
+
+void ReferenceBackend::setState(const CpuState &state)
+{
+    // Finish any instruction in progress so the next step starts a new one
+    while ( !_executor.complete() )
+        _executor.clock();
+
+    _registers = state.registers;
+    _memory = state.memory;
+    _executor.clock_ticks = state.cycles;
+    _write_hash = state.write_hash;
+}
+
+void ReferenceBackend::getState(CpuState &state) const
+{
+    state.registers = _registers;
+    state.memory = _memory;
+    state.cycles = _executor.clock_ticks;
+    state.write_hash = _write_hash;
+}
+
+void ReferenceBackend::step()
+{
+    do
+        _executor.clock();
+    while ( !_executor.complete() );
+}
@@ -0,0 +1,96 @@
+#ifndef CPUBACKEND_HPP
+#define CPUBACKEND_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include "instructionexecutor.hpp"
+
+
+/** Everything needed to start a CPU backend off in a known state. */
+struct CpuState
+{
+    using memoryType = std::array<uint8_t, 64 * 1024>;
+
+    Registers  registers;
+    memoryType memory{};
+    uint64_t   cycles = 0;
+    uint64_t   write_hash = 0; ///< @see CpuBackend::writeHash()
+};
+
+/** A way of executing 6502 instructions over its own 64KB of memory.
+ *
+ *  @c InstructionExecutor is the reference.  Faster ways of executing
+ *  (different dispatch, lazy flags, caching decoded blocks) implement this too,
+ *  so the @c LockstepChecker can run them side by side with the reference and
+ *  catch the first instruction where they disagree.
+ */
+class CpuBackend
+{
+public:
+    virtual ~CpuBackend() = default;
+
+    /** Creates a backend by name.
+     *
+     *  @param name "reference" is the only one so far
+     *
+     *  @return The backend, or nullptr if there is none by that name
+     */
+    static std::unique_ptr<CpuBackend> Create(std::string_view name);
+
+    virtual void setState(const CpuState &state) = 0;
+    virtual void getState(CpuState &state) const = 0;
+
+    /// Executes one whole instruction
+    virtual void step() = 0;
+
+    virtual const Registers            &registers() const = 0;
+    virtual const CpuState::memoryType &memory() const = 0;
+    virtual uint64_t                    cycles() const = 0;
+
+    /** A running hash of every write made, in order.
+     *
+     *  Two backends that agree on this have made the same writes, without
+     *  having to compare all of memory.
+     */
+    virtual uint64_t writeHash() const = 0;
+
+    /// Adds a write to a running hash
+    static uint64_t HashWrite(uint64_t hash, uint16_t address, uint8_t data)
+    {
+        // FNV-1a
+        constexpr uint64_t Prime = 0x100000001B3ull;
+
+        hash = (hash ^ (address & 0xFF)) * Prime;
+        hash = (hash ^ (address >> 8)) * Prime;
+        return (hash ^ data) * Prime;
+    }
+
+    static constexpr uint64_t InitialWriteHash = 0xCBF29CE484222325ull;
+};
+
+/** Runs instructions with @c InstructionExecutor, the emulator's own core. */
+class ReferenceBackend : public CpuBackend
+{
+public:
+    ReferenceBackend();
+
+    void setState(const CpuState &state) override;
+    void getState(CpuState &state) const override;
+
+    void step() override;
+
+    const Registers            &registers() const override { return _registers; }
+    const CpuState::memoryType &memory() const override { return _memory; }
+    uint64_t                    cycles() const override { return _executor.clock_ticks; }
+    uint64_t                    writeHash() const override { return _write_hash; }
+
+protected:
+    CpuState::memoryType _memory{};
+    Registers            _registers;
+    uint64_t             _write_hash = InitialWriteHash;
+    InstructionExecutor  _executor;
+};
+
+#endif // CPUBACKEND_HPP
@@ -1,5 +1,8 @@
 #include "disassembly.hpp"
 #include "ftxui/dom/elements.hpp"
+#include "ftxui/component/event.hpp"
+#include <iterator>
+#include <algorithm>
 
 using namespace ftxui;
 
@@ -41,11 +44,6 @@ public:
         :
         _options( std::move(options) )
     {
-        _options().ram->connect( _options().ram, &RamBusDevice::memoryChanged,
-                                [this](IBusDevice::addressType address, uint8_t data)
-                                {
-                                    _memoryChanged(address, data);
-                                });
     }
 
     Element OnRender() override
@@ -59,32 +57,106 @@ public:
         {
             elements.reserve( lines );
 
-            _options().start_address = _options().model->pc();
-            _options().end_address   = _options().model->pc() + 127;
+            _options().start_address = _programCounter();
+            _options().end_address   = _programCounter() + 127;
 
-            if ( !_isInDisassembly(_options().start_address()) )
+            if ( !_isInDisassembly(_options().start_address()) || _isOutOfDate() )
                 _generateDisassembly();
 
+            _clampSelectedLine();
+
+            int line = 0;
+
             for (const auto &iCurrentInstruction : _disassembly)
             {
-                if ( iCurrentInstruction.first == _options().model->pc() )
-                    elements.emplace_back( text( iCurrentInstruction.second ) | bgcolor(Color::Blue) );
-                else
-                    elements.emplace_back( text( iCurrentInstruction.second ) );
+                Element instruction = text( iCurrentInstruction.second );
+
+                if ( _hasBreakpoint( iCurrentInstruction.first ) )
+                    instruction = instruction | color( _options().has_condition( iCurrentInstruction.first ) ? Color::Yellow : Color::Red );
+                if ( iCurrentInstruction.first == _programCounter() )
+                    instruction = instruction | bgcolor(Color::Blue);
+                if ( line == _selected_line )
+                {
+                    _options().selected_address() = iCurrentInstruction.first;
+                    if ( Focused() )
+                        instruction = instruction | inverted;
+                }
+
+                elements.emplace_back( instruction );
+                ++line;
             }
         }
         return vbox( elements ) | size(WIDTH, EQUAL, format_length) | size(HEIGHT, GREATER_THAN, 0) | reflect( _box );
     }
 
-    bool Focusable() const final { return false; }
+    bool OnEvent(Event event) override
+    {
+        if ( !Focused() || event.is_mouse() )
+            return false;
+
+        if ( event == Event::ArrowUp )
+        {
+            // Let the focus leave the top of the list
+            if ( _selected_line == 0 )
+                return false;
+            --_selected_line;
+            return true;
+        }
+        else if ( event == Event::ArrowDown )
+        {
+            if ( _selected_line + 1 >= _visibleLines() )
+                return false;
+            ++_selected_line;
+            return true;
+        }
+        else if ( (event == Event::Return) || (event == Event::Character('b')) )
+        {
+            if ( _selected_line < static_cast<int>(_disassembly.size()) )
+                _options().on_toggle_breakpoint( std::next( _disassembly.begin(), _selected_line )->first );
+            return true;
+        }
+        else if ( event == Event::Character('c') )
+        {
+            if ( _selected_line < static_cast<int>(_disassembly.size()) )
+                _options().on_edit_condition( std::next( _disassembly.begin(), _selected_line )->first );
+            return true;
+        }
+
+        return false;
+    }
+
+    bool Focusable() const final { return true; }
 
 
 protected:
     Ref<DisassemblyOption> _options;
     Box                    _box;
     olc6502::disassemblyType _disassembly;
+    int                    _selected_line = 0;
+    uint64_t               _generation = 0; ///< Of the memory _disassembly was made from
+
+    olc6502::addressType _programCounter() const
+    {
+        return _options().snapshot ? _options().snapshot->registers.program_counter : _options().model->pc();
+    }
+
+    bool _hasBreakpoint(olc6502::addressType address) const
+    {
+        return _options().breakpoints && _options().breakpoints->test( Breakpoints::Execute, address );
+    }
+
+    int _visibleLines() const
+    {
+        int box_lines = _box.y_max - _box.y_min + 1;
+
+        return std::min( box_lines, static_cast<int>(_disassembly.size()) );
+    }
+
+    void _clampSelectedLine()
+    {
+        _selected_line = std::max( 0, std::min( _selected_line, _visibleLines() - 1 ) );
+    }
 
-    void _memoryChanged(IBusDevice::addressType address, uint8_t data);
     bool _isInDisassembly(const olc6502::addressType address) const
     {
         return !_disassembly.empty() &&
@@ -92,21 +164,45 @@ protected:
                (_disassembly.crbegin()->first >= address);
     }
 
+    bool _isOutOfDate() const
+    {
+        if ( _disassembly.empty() )
+            return false;
+
+        // Snapshots keep the same generations as the memory they are taken
+        // from, so it doesn't matter which of them it was made from.  The
+        // last instruction's operand bytes can run into the next page.
+        const olc6502::addressType first = _disassembly.cbegin()->first;
+        const olc6502::addressType last  = static_cast<olc6502::addressType>(
+                                               std::min<uint32_t>( uint32_t(_disassembly.crbegin()->first) + 2, 0xFFFF ) );
+
+        if ( _options().snapshot )
+            return _options().snapshot->changedSince( first, last, _generation );
+        return _options().ram->changedSince( first, last, _generation );
+    }
+
     void _generateDisassembly()
     {
+        const MachineSnapshot *snapshot = _options().snapshot;
+
         // Disassemble from the pc forward...
-        _disassembly = _options().model->disassemble( _options().start_address(), _options().end_address() );
+        if ( snapshot )
+        {
+            _disassembly = _options().model->disassemble( _options().start_address(), _options().end_address(),
+                                                          [snapshot](olc6502::addressType address, bool)
+                                                          {
+                                                              return snapshot->memory[address];
+                                                          });
+            _generation = snapshot->generation;
+        }
+        else
+        {
+            _disassembly = _options().model->disassemble( _options().start_address(), _options().end_address() );
+            _generation = _options().ram->generation();
+        }
     }
 };
 
-void Disassembly::_memoryChanged(IBusDevice::addressType address, uint8_t data)
-{
-    Q_UNUSED(data)
-
-    if ( _isInDisassembly(address) )
-        _generateDisassembly();
-}
-
 ftxui::Component disassembly(ftxui::Ref<DisassemblyOption> options)
 {
     return Make<Disassembly>( std::move(options) );
@@ -4,6 +4,9 @@
 #include "ftxui/component/component.hpp"
 #include "emulator/olc6502.hpp"
 #include "emulator/rambusdevice.hpp"
+#include "emulator/breakpoints.hpp"
+#include "emulator/machinesnapshot.hpp"
+#include <functional>
 
 struct DisassemblyOption
 {
@@ -11,6 +14,21 @@ struct DisassemblyOption
     RamBusDevice  *ram = nullptr;
     ftxui::Ref<olc6502::addressType> start_address;
     ftxui::Ref<olc6502::addressType> end_address;
+
+    const Breakpoints *breakpoints = nullptr;
+
+    /// While set, the program counter and memory are taken from this instead of the model
+    const MachineSnapshot *snapshot = nullptr;
+
+    /// Receives the address of the selected line
+    ftxui::Ref<olc6502::addressType> selected_address;
+
+    /// Called with the address of the selected line when a breakpoint is toggled.
+    std::function<void(olc6502::addressType)> on_toggle_breakpoint = [](olc6502::addressType) {};
+    /// Called with the address of the selected line when its breakpoint condition is to be edited.
+    std::function<void(olc6502::addressType)> on_edit_condition = [](olc6502::addressType) {};
+    /// Tells whether the breakpoint at an address has a condition attached.
+    std::function<bool(olc6502::addressType)> has_condition = [](olc6502::addressType) { return false; };
 };
 
 ftxui::Component disassembly(ftxui::Ref<DisassemblyOption> options);
@@ -0,0 +1,21 @@
+#include "flightrecorder.hpp"
+#include <cstdio>
+
+
+void FlightRecorder::exportTo(std::ostream &output, const std::function<std::string (uint8_t)> &mnemonic_name) const
+{
+    char buffer[64];
+
+    output << "     cycle  pc     op\n";
+    for (size_t index = 0; index < size(); ++index)
+    {
+        const Entry &entry = at( index );
+
+        snprintf(buffer, sizeof(buffer), "%10u  $%04X  %02X %s\n",
+                 static_cast<unsigned int>(entry.cycle),
+                 static_cast<unsigned int>(entry.program_counter),
+                 static_cast<unsigned int>(entry.opcode),
+                 mnemonic_name ? mnemonic_name( entry.opcode ).c_str() : "");
+        output << buffer;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef FLIGHTRECORDER_HPP
+#define FLIGHTRECORDER_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+
+/** A ring buffer of the most recently executed instructions.
+ *
+ *  The CPU records every instruction it starts, so after a program has
+ *  crashed into a BRK or wandered off into data the path that led there can
+ *  be looked at without having turned on any tracing beforehand.  Each entry
+ *  is 8 bytes and recording one is a few stores into a fixed array, which
+ *  keeps it cheap enough to leave on all the time.
+ */
+class FlightRecorder
+{
+public:
+    using addressType = uint16_t;
+
+    struct Entry
+    {
+        uint32_t    cycle = 0;           ///< The low 32 bits of the clock tick the instruction started on
+        addressType program_counter = 0;
+        uint8_t     opcode = 0;
+    };
+
+    /// The number of entries kept.  A power of two so the index is just masked.
+    static constexpr size_t Capacity = 4096;
+
+    void record(addressType program_counter, uint8_t opcode, uint32_t cycle)
+    {
+        Entry &entry = _entries[_recorded & (Capacity - 1)];
+
+        entry.cycle = cycle;
+        entry.program_counter = program_counter;
+        entry.opcode = opcode;
+        ++_recorded;
+    }
+
+    /// The number of entries that can be looked at, up to @c Capacity.
+    size_t size() const { return (_recorded < Capacity) ? static_cast<size_t>(_recorded) : Capacity; }
+    bool   empty() const { return _recorded == 0; }
+
+    /// The total number of instructions recorded since the last @c clear().
+    uint64_t recorded() const { return _recorded; }
+
+    /** Gets an entry.
+     *
+     *  @param index 0 is the oldest entry kept, size() - 1 the most recent
+     */
+    const Entry &at(size_t index) const { return _entries[(_recorded - size() + index) & (Capacity - 1)]; }
+    const Entry &last() const { return at( size() - 1 ); }
+
+    void clear() { _recorded = 0; }
+
+    /** Writes the entries, oldest first, one instruction per line.
+     *
+     *  @param output        The stream to write to
+     *  @param mnemonic_name Gives the mnemonic of an opcode for display
+     */
+    void exportTo(std::ostream &output, const std::function<std::string (uint8_t)> &mnemonic_name) const;
+
+protected:
+    std::array<Entry, Capacity> _entries;
+    uint64_t                    _recorded = 0;
+};
+
+#endif // FLIGHTRECORDER_HPP
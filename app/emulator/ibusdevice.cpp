@@ -1,4 +1,6 @@
 #include "ibusdevice.hpp"
+#include <algorithm>
+#include <vector>
 
 
 IBusDevice::IBusDevice(uint16_t  lower_address,
@@ -36,3 +38,92 @@ uint8_t IBusDevice::read(uint16_t address, bool read_only)
         return readImplementation(address, read_only);
     return 0x00;
 }
+
+void IBusDevice::readBlock(uint16_t address, uint8_t *data, size_t size, bool read_only)
+{
+    const auto range = readable() ? blockInRange( address, size ) : std::nullopt;
+
+    if ( !range )
+    {
+        std::fill_n( data, size, 0x00 );
+        return;
+    }
+
+    const size_t offset = range->first - address;
+
+    std::fill_n( data, offset, 0x00 );
+    readBlockImplementation( range->first, data + offset, range->second, read_only );
+    std::fill( data + offset + range->second, data + size, 0x00 );
+}
+
+void IBusDevice::writeBlock(uint16_t address, const uint8_t *data, size_t size)
+{
+    const auto range = writable() ? blockInRange( address, size ) : std::nullopt;
+
+    if ( range )
+        writeBlockImplementation( range->first, data + (range->first - address), range->second );
+}
+
+void IBusDevice::fill(uint16_t address, size_t size, uint8_t value)
+{
+    const auto range = writable() ? blockInRange( address, size ) : std::nullopt;
+
+    if ( range )
+        fillImplementation( range->first, range->second, value );
+}
+
+void IBusDevice::copy(uint16_t destination, uint16_t source, size_t size)
+{
+    const auto from = blockInRange( source, size );
+    const auto to   = blockInRange( destination, size );
+
+    // The whole of both blocks in range is the usual case, and can be done in place
+    if ( readable() && writable() && from && to &&
+         (from->first == source) && (to->first == destination) && (from->second == size) && (to->second == size) )
+    {
+        copyImplementation( destination, source, size );
+        return;
+    }
+
+    std::vector<uint8_t> buffer( size );
+
+    readBlock( source, buffer.data(), size, false );
+    writeBlock( destination, buffer.data(), size );
+}
+
+void IBusDevice::readBlockImplementation(uint16_t address, uint8_t *data, size_t size, bool read_only)
+{
+    for (size_t iCurrentByte = 0; iCurrentByte < size; ++iCurrentByte)
+        data[iCurrentByte] = readImplementation( static_cast<addressType>(address + iCurrentByte), read_only );
+}
+
+void IBusDevice::writeBlockImplementation(uint16_t address, const uint8_t *data, size_t size)
+{
+    for (size_t iCurrentByte = 0; iCurrentByte < size; ++iCurrentByte)
+        writeImplementation( static_cast<addressType>(address + iCurrentByte), data[iCurrentByte] );
+}
+
+void IBusDevice::fillImplementation(uint16_t address, size_t size, uint8_t value)
+{
+    for (size_t iCurrentByte = 0; iCurrentByte < size; ++iCurrentByte)
+        writeImplementation( static_cast<addressType>(address + iCurrentByte), value );
+}
+
+void IBusDevice::copyImplementation(uint16_t destination, uint16_t source, size_t size)
+{
+    std::vector<uint8_t> buffer( size );
+
+    readBlockImplementation( source, buffer.data(), size, false );
+    writeBlockImplementation( destination, buffer.data(), size );
+}
+
+std::optional<std::pair<IBusDevice::addressType, size_t>> IBusDevice::blockInRange(uint16_t address, size_t size) const
+{
+    // Worked out in 32 bits, as a block can end past $FFFF
+    const uint32_t first = std::max<uint32_t>( address, _lower_address_range );
+    const uint32_t end   = static_cast<uint32_t>( std::min<size_t>( size_t(address) + size, size_t(_upper_address_range) + 1 ) );
+
+    if ( first >= end )
+        return std::nullopt;
+    return std::make_pair( static_cast<addressType>(first), size_t(end - first) );
+}
@@ -2,6 +2,9 @@
 #define IBUSDEVICE_HPP
 
 #include <QObject>
+#include <cstddef>
+#include <optional>
+#include <utility>
 
 class IBusDevice : public QObject
 {
@@ -30,10 +33,45 @@ public slots:
     void    write(addressType address, uint8_t data);
     uint8_t read(addressType address, bool read_only);
 
+public:
+    /** @name Blocks
+     *  Accesses a run of consecutive addresses at once.
+     *
+     *  Only the part of a block within this device's range is accessed, and
+     *  blocks don't wrap around past $FFFF.  Anything else is skipped when
+     *  writing and reads as 0.  Devices whose memory is plain storage do these
+     *  in one go, others a byte at a time as if through @c read() and @c write().
+     */
+    ///@{
+    void readBlock(addressType address, uint8_t *data, size_t size, bool read_only);
+    void writeBlock(addressType address, const uint8_t *data, size_t size);
+    void fill(addressType address, size_t size, uint8_t value);
+
+    /// Copies as if through a temporary buffer, so the two blocks may overlap
+    void copy(addressType destination, addressType source, size_t size);
+    ///@}
+
 protected:
     virtual void    writeImplementation(addressType address, uint8_t data) = 0;
     virtual uint8_t readImplementation(addressType address, bool read_only) = 0;
 
+    /** @name Block implementations
+     *  Only ever called with blocks entirely within this device's range.  By
+     *  default these go a byte at a time.
+     */
+    ///@{
+    virtual void readBlockImplementation(addressType address, uint8_t *data, size_t size, bool read_only);
+    virtual void writeBlockImplementation(addressType address, const uint8_t *data, size_t size);
+    virtual void fillImplementation(addressType address, size_t size, uint8_t value);
+    virtual void copyImplementation(addressType destination, addressType source, size_t size);
+    ///@}
+
+    /** Finds the part of a block within this device's range.
+     *
+     *  @return The first address of it and its size, or nothing if none of the block is in range
+     */
+    std::optional<std::pair<addressType, size_t>> blockInRange(addressType address, size_t size) const;
+
 private:
     addressType _lower_address_range = 0;
     addressType _upper_address_range = 0;
@@ -1,6 +1,11 @@
 #include "instructionexecutor.hpp"
+#include "utilities/Profiling.hpp"
+#include "statehash.hpp"
 
 
+static constexpr uint8_t TXSOpcode = 0x9A;
+static constexpr uint32_t DirectPagesEnd = 0x0200; // Just past the stack
+
 InstructionExecutor::InstructionExecutor(Registers    &registers,
                                          readDelegate  read_signal,
                                          writeDelegate write_signal,
@@ -91,7 +96,7 @@ uint8_t InstructionExecutor::IMM()
 // one byte instead of the usual two.
 uint8_t InstructionExecutor::ZP0()
 {
-    _addr_abs = read(registers().program_counter);
+    _addr_abs = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
     _addr_abs &= 0x00FF;
     return 0;
@@ -103,7 +108,7 @@ uint8_t InstructionExecutor::ZP0()
 // ranges within the first page.
 uint8_t InstructionExecutor::ZPX()
 {
-    _addr_abs = (read(registers().program_counter) + registers().x);
+    _addr_abs = (fetchInstructionByte(registers().program_counter) + registers().x);
     registers().program_counter++;
     _addr_abs &= 0x00FF;
     return 0;
@@ -113,7 +118,7 @@ uint8_t InstructionExecutor::ZPX()
 // Same as above but uses Y Register for offset
 uint8_t InstructionExecutor::ZPY()
 {
-    _addr_abs = (read(registers().program_counter) + registers().y);
+    _addr_abs = (fetchInstructionByte(registers().program_counter) + registers().y);
     registers().program_counter++;
     _addr_abs &= 0x00FF;
     return 0;
@@ -125,7 +130,7 @@ uint8_t InstructionExecutor::ZPY()
 // you cant directly branch to any address in the addressable range.
 uint8_t InstructionExecutor::REL()
 {
-    _addr_rel = read(registers().program_counter);
+    _addr_rel = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
     if (_addr_rel & 0x80)
         _addr_rel |= 0xFF00;
@@ -136,9 +141,9 @@ uint8_t InstructionExecutor::REL()
 // A full 16-bit address is loaded and used
 uint8_t InstructionExecutor::ABS()
 {
-    uint16_t lo = read(registers().program_counter);
+    uint16_t lo = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
-    uint16_t hi = read(registers().program_counter);
+    uint16_t hi = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
     _addr_abs = (hi << 8) | lo;
 
@@ -151,9 +156,9 @@ uint8_t InstructionExecutor::ABS()
 // the page, an additional clock cycle is required
 uint8_t InstructionExecutor::ABX()
 {
-    uint16_t lo = read(registers().program_counter);
+    uint16_t lo = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
-    uint16_t hi = read(registers().program_counter);
+    uint16_t hi = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
 
     _addr_abs = (hi << 8) | lo;
@@ -172,9 +177,9 @@ uint8_t InstructionExecutor::ABX()
 uint8_t InstructionExecutor::ABY()
 
 {
-    uint16_t lo = read(registers().program_counter);
+    uint16_t lo = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
-    uint16_t hi = read(registers().program_counter);
+    uint16_t hi = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
 
     _addr_abs = (hi << 8) | lo;
@@ -199,9 +204,9 @@ uint8_t InstructionExecutor::ABY()
 // invalid actual address
 uint8_t InstructionExecutor::IND()
 {
-    uint16_t ptr_lo = read(registers().program_counter);
+    uint16_t ptr_lo = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
-    uint16_t ptr_hi = read(registers().program_counter);
+    uint16_t ptr_hi = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
 
     uint16_t ptr = (ptr_hi << 8) | ptr_lo;
@@ -223,7 +228,7 @@ uint8_t InstructionExecutor::IND()
 // from this location
 uint8_t InstructionExecutor::IZX()
 {
-    uint16_t t = read(registers().program_counter);
+    uint16_t t = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
 
     uint16_t lo = read((uint16_t)(t + (uint16_t)registers().x) & 0x00FF);
@@ -241,7 +246,7 @@ uint8_t InstructionExecutor::IZX()
 // change in page then an additional clock cycle is required.
 uint8_t InstructionExecutor::IZY()
 {
-    uint16_t t = read(registers().program_counter);
+    uint16_t t = fetchInstructionByte(registers().program_counter);
     registers().program_counter++;
 
     uint16_t lo = read(t & 0x00FF);
@@ -270,19 +275,63 @@ uint8_t InstructionExecutor::IZY()
 // function. It also returns it for convenience.
 uint8_t InstructionExecutor::fetch()
 {
-    if (!(_lookup[_opcode].addrmode == &InstructionExecutor::IMP))
+    if (_lookup[_opcode].addrmode == &InstructionExecutor::IMM)
+        _fetched = fetchInstructionByte(_addr_abs);
+    else if (!(_lookup[_opcode].addrmode == &InstructionExecutor::IMP))
         _fetched = read(_addr_abs);
     return _fetched;
 }
 
+uint8_t InstructionExecutor::fetchInstructionByte(addressType address)
+{
+    if (_heatmap)
+        _heatmap->countExecute(address);
+    return (_read_delegate) ? _read_delegate(address, false) : 0x00;
+}
+
 uint8_t InstructionExecutor::read(addressType address, bool read_only)
 {
+    if (_fast_pages && address < DirectPagesEnd)
+    {
+        if (!read_only)
+            _usage_monitor.touchZeroPage(address);
+        return _fast_pages[address];
+    }
+    if (_heatmap && !read_only)
+        _heatmap->countRead(address);
+    if (_watchpoints && !read_only && _watchpoints->test(Breakpoints::Read, address))
+        _watchpoints->trigger(Breakpoints::Read, address);
+    if (!read_only)
+        _usage_monitor.touchZeroPage(address);
+    if (_direct_pages && address < DirectPagesEnd)
+        return _direct_pages[address];
     return (_read_delegate) ? _read_delegate(address, read_only) : 0x00;
 }
 
 void InstructionExecutor::write(addressType address, uint8_t data)
 {
-    if (_write_delegate)
+    if (_fast_pages && address < DirectPagesEnd)
+    {
+        _usage_monitor.touchZeroPage(address);
+        _fast_pages[address] = data;
+        *_direct_dirty_pages |= uint64_t(1) << (address >> 8);
+        return;
+    }
+    if (_heatmap)
+        _heatmap->countWrite(address);
+    if (_watchpoints && _watchpoints->test(Breakpoints::Write, address))
+        _watchpoints->trigger(Breakpoints::Write, address);
+    if (_write_provenance)
+        _write_provenance->record(address, _instruction_address, clock_ticks);
+    _usage_monitor.touchZeroPage(address);
+    if (_statistics)
+        _statistics->countWrite(address);
+    if (_direct_pages && address < DirectPagesEnd)
+    {
+        _direct_pages[address] = data;
+        *_direct_dirty_pages |= uint64_t(1) << (address >> 8);
+    }
+    else if (_write_delegate)
         _write_delegate(address, data);
 }
 
@@ -310,6 +359,9 @@ void InstructionExecutor::reset()
     registers().stack_pointer = 0xFD;
     registers().status = 0x00 | U;
 
+    // Start watching the stack and zero page afresh
+    _usage_monitor.reset(registers().stack_pointer);
+
     // Clear internal helper variables
     _addr_rel = 0x0000;
     _addr_abs = 0x0000;
@@ -331,6 +383,8 @@ void InstructionExecutor::irq()
     // If interrupts are allowed
     if (GetFlag(I) == 0)
     {
+        const uint8_t stack_pointer_before = registers().stack_pointer;
+
         // Push the program counter to the stack. It's 16-bits dont
         // forget so that takes two pushes
         write(0x0100 + registers().stack_pointer, (registers().program_counter >> 8) & 0x00FF);
@@ -349,15 +403,21 @@ void InstructionExecutor::irq()
         _addr_abs = 0xFFFE;
         uint16_t lo = read(_addr_abs + 0);
         uint16_t hi = read(_addr_abs + 1);
+        _usage_monitor.noteStackPointer(stack_pointer_before, registers().stack_pointer, registers().program_counter, false);
         registers().program_counter = (hi << 8) | lo;
 
         // IRQs take time
         _cycles = 7;
+
+        if (_statistics)
+            SessionStatistics::Increment(_statistics->irqs);
     }
 }
 
 void InstructionExecutor::nmi()
 {
+    const uint8_t stack_pointer_before = registers().stack_pointer;
+
     write(0x0100 + registers().stack_pointer, (registers().program_counter >> 8) & 0x00FF);
     registers().stack_pointer--;
     write(0x0100 + registers().stack_pointer, registers().program_counter & 0x00FF);
@@ -372,9 +432,13 @@ void InstructionExecutor::nmi()
     _addr_abs = 0xFFFA;
     uint16_t lo = read(_addr_abs + 0);
     uint16_t hi = read(_addr_abs + 1);
+    _usage_monitor.noteStackPointer(stack_pointer_before, registers().stack_pointer, registers().program_counter, false);
     registers().program_counter = (hi << 8) | lo;
 
     _cycles = 8;
+
+    if (_statistics)
+        SessionStatistics::Increment(_statistics->nmis);
 }
 
 void InstructionExecutor::clock()
@@ -397,7 +461,11 @@ void InstructionExecutor::clock()
         // Read next instruction byte. This 8-bit value is used to index
         // the translation table to get the relevant information about
         // how to implement the instruction
-        _opcode = read(registers().program_counter);
+        _instruction_address = registers().program_counter;
+        _opcode = fetchInstructionByte(_instruction_address);
+
+        _flight_recorder.record(_instruction_address, _opcode, static_cast<uint32_t>(clock_ticks));
+        ++instruction_count;
 
 #if 0
         uint16_t log_pc = registers().program_counter; // For logging
@@ -419,6 +487,9 @@ void InstructionExecutor::clock()
         // Perform operation
         uint8_t additional_cycle2 = (this->*_lookup[_opcode].operate)();
 
+        // Branches add their own cycles directly
+        uint8_t branch_cycles = _cycles - _lookup[_opcode].cycles;
+
         // The addressmode and opcode may have altered the number
         // of cycles this instruction requires before its completed
         _cycles += (additional_cycle1 & additional_cycle2);
@@ -426,9 +497,16 @@ void InstructionExecutor::clock()
         if (additional_cycle2 > 1)
             _cycles += additional_cycle2 - 1; // Takes care of being in BCD mode
 
+        if (_profile)
+            _profile->count(_opcode, _cycles, additional_cycle1 & additional_cycle2, branch_cycles,
+                            (additional_cycle2 > 1) ? additional_cycle2 - 1 : 0);
+
         // Always set the unused status flag bit to 1
         SetFlag(U, true);
 
+        _usage_monitor.noteStackPointer(registers_before.stack_pointer, registers().stack_pointer,
+                                        _instruction_address, _opcode == TXSOpcode);
+
 #if 0
         if (log())
         {
@@ -466,8 +544,44 @@ void InstructionExecutor::clock()
     _cycles--;
 }
 
+std::string InstructionExecutor::addressingMode(uint8_t opcode) const
+{
+    static const std::pair<uint8_t (InstructionExecutor::*)(void), const char *> Names[] = {
+        { &InstructionExecutor::IMP, "IMP" }, { &InstructionExecutor::IMM, "IMM" },
+        { &InstructionExecutor::ZP0, "ZP0" }, { &InstructionExecutor::ZPX, "ZPX" },
+        { &InstructionExecutor::ZPY, "ZPY" }, { &InstructionExecutor::REL, "REL" },
+        { &InstructionExecutor::ABS, "ABS" }, { &InstructionExecutor::ABX, "ABX" },
+        { &InstructionExecutor::ABY, "ABY" }, { &InstructionExecutor::IND, "IND" },
+        { &InstructionExecutor::IZX, "IZX" }, { &InstructionExecutor::IZY, "IZY" } };
+
+    for (const auto &[mode, name] : Names)
+    {
+        if ( _lookup[opcode].addrmode == mode )
+            return name;
+    }
+    return std::string();
+}
+
+uint64_t InstructionExecutor::stateHash() const
+{
+    uint64_t hash = HashCombine( 0, registers().program_counter );
+
+    hash = HashCombine( hash, (uint64_t{registers().a} << 24) | (registers().x << 16) | (registers().y << 8) | registers().stack_pointer );
+    hash = HashCombine( hash, registers().status );
+    hash = HashCombine( hash, (uint64_t{_cycles} << 8) | _opcode );
+    hash = HashCombine( hash, clock_ticks );
+    return HashCombine( hash, instruction_count );
+}
+
 auto InstructionExecutor::disassemble(addressType start, addressType stop) const -> disassemblyType
 {
+    return disassemble( start, stop, _read_delegate );
+}
+
+auto InstructionExecutor::disassemble(addressType start, addressType stop, const readDelegate &read_memory) const -> disassemblyType
+{
+    PROFILE_ZONE("InstructionExecutor::disassemble");
+
     size_t  addr = start; // MUST be a value type that holds more values than start!
     uint8_t value = 0x00, lo = 0x00, hi = 0x00;
     size_t  line_addr = 0;
@@ -501,7 +615,7 @@ auto InstructionExecutor::disassemble(addressType start, addressType stop) const
         std::string sInst = "$" + hex(addr, 4) + ": ";
 
         // Read instruction, and get its readable name
-        uint8_t opcode = _read_delegate(addr, true); addr++;
+        uint8_t opcode = read_memory(addr, true); addr++;
         sInst += _lookup[opcode].name + " ";
 
         // Get oprands from desired locations, and form the
@@ -515,76 +629,76 @@ auto InstructionExecutor::disassemble(addressType start, addressType stop) const
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::IMM)
         {
-            value = _read_delegate(addr, true); addr++;
+            value = read_memory(addr, true); addr++;
             //sInst += "#$" + hex(value, 2) + " {IMM}";
             sInst += "#$" + hex(value, 2);
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::ZP0)
         {
-            lo = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
             hi = 0x00;
             //sInst += "$" + hex(lo, 2) + " {ZP0}";
             sInst += "$" + hex(lo, 2);
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::ZPX)
         {
-            lo = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
             hi = 0x00;
             //sInst += "$" + hex(lo, 2) + ", X {ZPX}";
             sInst += "$" + hex(lo, 2) + ", X";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::ZPY)
         {
-            lo = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
             hi = 0x00;
             //sInst += "$" + hex(lo, 2) + ", Y {ZPY}";
             sInst += "$" + hex(lo, 2) + ", Y";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::IZX)
         {
-            lo = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
             hi = 0x00;
             //sInst += "($" + hex(lo, 2) + ", X) {IZX}";
             sInst += "($" + hex(lo, 2) + ", X)";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::IZY)
         {
-            lo = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
             hi = 0x00;
             //sInst += "($" + hex(lo, 2) + "), Y {IZY}";
             sInst += "($" + hex(lo, 2) + "), Y";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::ABS)
         {
-            lo = _read_delegate(addr, true); addr++;
-            hi = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
+            hi = read_memory(addr, true); addr++;
             //sInst += "$" + hex((uint16_t)(hi << 8) | lo, 4) + " {ABS}";
             sInst += "$" + hex((uint16_t)(hi << 8) | lo, 4);
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::ABX)
         {
-            lo = _read_delegate(addr, true); addr++;
-            hi = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
+            hi = read_memory(addr, true); addr++;
             //sInst += "$" + hex((uint16_t)(hi << 8) | lo, 4) + ", X {ABX}";
             sInst += "$" + hex((uint16_t)(hi << 8) | lo, 4) + ", X";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::ABY)
         {
-            lo = _read_delegate(addr, true); addr++;
-            hi = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
+            hi = read_memory(addr, true); addr++;
             //sInst += "$" + hex((uint16_t)(hi << 8) | lo, 4) + ", Y {ABY}";
             sInst += "$" + hex((uint16_t)(hi << 8) | lo, 4) + ", Y";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::IND)
         {
-            lo = _read_delegate(addr, true); addr++;
-            hi = _read_delegate(addr, true); addr++;
+            lo = read_memory(addr, true); addr++;
+            hi = read_memory(addr, true); addr++;
             //sInst += "($" + hex((uint16_t)(hi << 8) | lo, 4) + ") {IND}";
             sInst += "($" + hex((uint16_t)(hi << 8) | lo, 4) + ")";
         }
         else if (_lookup[opcode].addrmode == &InstructionExecutor::REL)
         {
-            value = _read_delegate(addr, true); addr++;
+            value = read_memory(addr, true); addr++;
             //sInst += "$" + hex(value, 2) + " [$" + hex(addr + value, 4) + "] {REL}";
             sInst += "$" + hex(value, 2) + "   [$" + hex(addr + (int8_t)value, 4) + "]";
         }
@@ -956,6 +1070,7 @@ uint8_t InstructionExecutor::BRK()
     SetFlag(B, 0);
 
     registers().program_counter = (uint16_t)read(0xFFFE) | ((uint16_t)read(0xFFFF) << 8);
+    _brk_executed = _stop_on_brk;
     return 0;
 }
 
@@ -6,6 +6,13 @@
 #include <vector>
 #include <string>
 #include "registers.hpp"
+#include "memoryheatmap.hpp"
+#include "breakpoints.hpp"
+#include "flightrecorder.hpp"
+#include "writeprovenance.hpp"
+#include "instructionprofile.hpp"
+#include "usagemonitor.hpp"
+#include "sessionstatistics.hpp"
 
 
 class InstructionExecutor
@@ -123,18 +130,85 @@ public:
 
     uint8_t remainingCyclesForInstruction() const { return _cycles; }
 
+    // The opcode of the instruction being executed, or of the last one once it has completed
+    uint8_t opcode() const { return _opcode; }
+
+    const std::string &mnemonic(uint8_t opcode) const { return _lookup[opcode].name; }
+
+    // The name of the addressing mode of an opcode, such as "ABX"
+    std::string addressingMode(uint8_t opcode) const;
+
     void reset();
     void irq();
     void nmi();
 
     void clock(); ///< Executes one clock tick
-    uint32_t clock_ticks = 0; // A global accumulation of the number of clocks
+    uint64_t clock_ticks = 0; // A global accumulation of the number of clocks
+    uint64_t instruction_count = 0; // And of the number of instructions started
 
     const Registers &registers() const { return _registers; }
           Registers &registers()       { return _registers; }
 
     auto disassemble(addressType start, addressType stop) const -> disassemblyType;
 
+    // The same, but reading the bytes through read_memory, such as from a copy of memory
+    auto disassemble(addressType start, addressType stop, const readDelegate &read_memory) const -> disassemblyType;
+
+    // Optional per-byte access counting.  Pass nullptr to turn it off again.
+    MemoryHeatmap *heatmap() const { return _heatmap; }
+    void setHeatmap(MemoryHeatmap *heatmap) { _heatmap = heatmap; updateFastPages(); }
+
+    // Read and write watchpoints are tested on every data access while this
+    // is set.  Leave it as nullptr when there are none so the test is skipped.
+    Breakpoints *watchpoints() const { return _watchpoints; }
+    void setWatchpoints(Breakpoints *watchpoints) { _watchpoints = watchpoints; updateFastPages(); }
+
+    // Optional recording of the instruction and cycle of the last write to each address.
+    // Pass nullptr to turn it off again.
+    WriteProvenance *writeProvenance() const { return _write_provenance; }
+    void setWriteProvenance(WriteProvenance *write_provenance) { _write_provenance = write_provenance; updateFastPages(); }
+
+    // Optional counting of the instructions executed and their extra cycles.
+    // Pass nullptr to turn it off again.
+    InstructionProfile *profile() const { return _profile; }
+    void setProfile(InstructionProfile *profile) { _profile = profile; }
+
+    // Optional counting of interrupts and of writes per page, for the session statistics.
+    // Pass nullptr to turn it off again.
+    SessionStatistics *statistics() const { return _statistics; }
+    void setStatistics(SessionStatistics *statistics) { _statistics = statistics; updateFastPages(); }
+
+    // While set, executing a BRK sets brkExecuted() until acknowledgeBrk().
+    // Only a flag is set, so a loop testing it stays as fast as one that doesn't.
+    bool stopOnBrk() const { return _stop_on_brk; }
+    void setStopOnBrk(bool stop) { _stop_on_brk = stop; }
+    bool brkExecuted() const { return _brk_executed; }
+    void acknowledgeBrk() { _brk_executed = false; }
+
+    // Pages $00 and $01 (the zero page and the stack), for when they are known
+    // to be plain RAM.  Accesses to them then read and write data directly
+    // instead of going through the delegates, and each write sets bit 0 or 1
+    // of dirty_pages for its page.  Pass nullptrs to go through the delegates again.
+    // While no heatmap, watchpoints, write provenance or statistics are set,
+    // these accesses are tested first and skip the instrumentation entirely.
+    void setDirectPages(uint8_t *data, uint64_t *dirty_pages) { _direct_pages = data; _direct_dirty_pages = dirty_pages; updateFastPages(); }
+    bool directPages() const { return _direct_pages != nullptr; }
+
+    // The stack and zero page high-water marks, always kept
+    const UsageMonitor &usageMonitor() const { return _usage_monitor; }
+          UsageMonitor &usageMonitor()       { return _usage_monitor; }
+
+    // Every instruction started is recorded here, unconditionally
+    const FlightRecorder &flightRecorder() const { return _flight_recorder; }
+          FlightRecorder &flightRecorder()       { return _flight_recorder; }
+
+    /** A hash of the registers and of what is left of the current instruction.
+     *
+     *  Memory is not included, it belongs to whoever provides the read and
+     *  write delegates.
+     */
+    uint64_t stateHash() const;
+
     static constexpr uint16_t NMIAddress = 0xFFFA;
     static constexpr uint16_t ResetJumpStartAddress = 0xFFFC;
     static constexpr uint16_t IRQAddress = 0xFFFE;
@@ -147,6 +221,7 @@ protected:
     uint16_t _addr_abs = 0x0000; // All used memory addresses end up in here
     uint16_t _addr_rel = 0x0000; // Represents absolute address following a branch
     uint8_t  _opcode = 0x00; // Is the instruction byte
+    uint16_t _instruction_address = 0x0000; // Where the current instruction's opcode was fetched from
     uint8_t  _cycles = 0; // Counts how many cycles the instruction has remaining
     std::vector<INSTRUCTION> _lookup;
     Registers    &_registers;
@@ -158,6 +233,18 @@ protected:
     registerValueChangedDelegate _stack_pointer_changed;
     addressValueChangedDelegate  _program_counter_changed;
     addressValueChangedDelegate  _status_changed;
+    MemoryHeatmap *_heatmap = nullptr;
+    Breakpoints   *_watchpoints = nullptr;
+    WriteProvenance *_write_provenance = nullptr;
+    InstructionProfile *_profile = nullptr;
+    SessionStatistics  *_statistics = nullptr;
+    bool      _stop_on_brk = false;
+    bool      _brk_executed = false;
+    uint8_t  *_direct_pages = nullptr; // $0000-$01FF, or nullptr to use the delegates
+    uint64_t *_direct_dirty_pages = nullptr;
+    uint8_t  *_fast_pages = nullptr; // _direct_pages while nothing instruments data accesses
+    FlightRecorder _flight_recorder;
+    UsageMonitor   _usage_monitor;
 
     struct BCDResult {
         uint8_t sum;
@@ -169,6 +256,17 @@ protected:
     // depending on address mode of instruction byte
     uint8_t fetch();
 
+    // Reads a byte of the instruction stream (opcode or operand), as opposed
+    // to data that the instruction operates on
+    uint8_t fetchInstructionByte(addressType address);
+
+    void updateFastPages()
+    {
+        const bool instrumented = _heatmap || _watchpoints || _write_provenance || _statistics;
+
+        _fast_pages = (instrumented) ? nullptr : _direct_pages;
+    }
+
     uint8_t read(addressType address, bool read_only = false);
     void    write(addressType address, uint8_t data);
 
@@ -0,0 +1,138 @@
+#include "instructionprofile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+
+InstructionProfile::counterType InstructionProfile::executed() const
+{
+    counterType total = 0;
+
+    for (const OpcodeCounters &iCurrentOpcode : _opcodes)
+        total += iCurrentOpcode.executed;
+    return total;
+}
+
+InstructionProfile::counterType InstructionProfile::cycles() const
+{
+    counterType total = 0;
+
+    for (const OpcodeCounters &iCurrentOpcode : _opcodes)
+        total += iCurrentOpcode.cycles;
+    return total;
+}
+
+InstructionProfile::counterType InstructionProfile::penalty(Penalty penalty) const
+{
+    counterType total = 0;
+
+    for (const OpcodeCounters &iCurrentOpcode : _opcodes)
+        total += iCurrentOpcode.penalties[penalty];
+    return total;
+}
+
+void InstructionProfile::exportTo(std::ostream &output,
+                                  const std::function<std::string (uint8_t)> &mnemonic_name,
+                                  const std::function<std::string (uint8_t)> &addressing_mode_name) const
+{
+    char buffer[128];
+    const counterType total_cycles = cycles();
+
+    snprintf(buffer, sizeof(buffer), "Instructions: %llu  Cycles: %llu\n\n",
+             static_cast<unsigned long long>(executed()),
+             static_cast<unsigned long long>(total_cycles));
+    output << buffer;
+
+    output << "Penalty cycles\n";
+    for (int iCurrentPenalty = 0; iCurrentPenalty < PenaltyCount; ++iCurrentPenalty)
+    {
+        const counterType lost = penalty( static_cast<Penalty>(iCurrentPenalty) );
+
+        snprintf(buffer, sizeof(buffer), "  %-18s %12llu  %5.1f%%\n",
+                 PenaltyName( static_cast<Penalty>(iCurrentPenalty) ),
+                 static_cast<unsigned long long>(lost),
+                 total_cycles ? (100.0 * lost / total_cycles) : 0.0);
+        output << buffer;
+    }
+
+    // Sum the opcodes up by addressing mode
+    std::map<std::string, OpcodeCounters> modes;
+
+    for (int opcode = 0; opcode < 256; ++opcode)
+    {
+        const OpcodeCounters &counters = _opcodes[opcode];
+
+        if ( counters.executed == 0 )
+            continue;
+
+        OpcodeCounters &mode = modes[ addressing_mode_name( static_cast<uint8_t>(opcode) ) ];
+
+        mode.executed += counters.executed;
+        mode.cycles   += counters.cycles;
+        for (int iCurrentPenalty = 0; iCurrentPenalty < PenaltyCount; ++iCurrentPenalty)
+            mode.penalties[iCurrentPenalty] += counters.penalties[iCurrentPenalty];
+    }
+
+    output << "\nBy addressing mode\n";
+    output << "  mode      executed        cycles    page cross\n";
+    for (const auto &[name, counters] : modes)
+    {
+        snprintf(buffer, sizeof(buffer), "  %-4s %13llu %13llu %13llu\n",
+                 name.c_str(),
+                 static_cast<unsigned long long>(counters.executed),
+                 static_cast<unsigned long long>(counters.cycles),
+                 static_cast<unsigned long long>(counters.penalties[PageCross] + counters.penalties[BranchPageCross]));
+        output << buffer;
+    }
+
+    // The instructions that lost the most to page crossings, worst first
+    std::vector<int> crossing;
+
+    for (int opcode = 0; opcode < 256; ++opcode)
+    {
+        if ( _opcodes[opcode].penalties[PageCross] + _opcodes[opcode].penalties[BranchPageCross] )
+            crossing.push_back( opcode );
+    }
+    std::sort( crossing.begin(), crossing.end(),
+               [this](int left, int right)
+               {
+                   return (_opcodes[left].penalties[PageCross] + _opcodes[left].penalties[BranchPageCross]) >
+                          (_opcodes[right].penalties[PageCross] + _opcodes[right].penalties[BranchPageCross]);
+               });
+
+    output << "\nPage crossing cycles by instruction\n";
+    output << "  op  instr       executed    page cross  of executed\n";
+    for (int opcode : crossing)
+    {
+        const OpcodeCounters &counters = _opcodes[opcode];
+        const counterType lost = counters.penalties[PageCross] + counters.penalties[BranchPageCross];
+
+        snprintf(buffer, sizeof(buffer), "  %02X  %-3s %-4s %12llu %13llu  %10.1f%%\n",
+                 static_cast<unsigned int>(opcode),
+                 mnemonic_name( static_cast<uint8_t>(opcode) ).c_str(),
+                 addressing_mode_name( static_cast<uint8_t>(opcode) ).c_str(),
+                 static_cast<unsigned long long>(counters.executed),
+                 static_cast<unsigned long long>(lost),
+                 100.0 * lost / counters.executed);
+        output << buffer;
+    }
+}
+
+const char *InstructionProfile::PenaltyName(Penalty penalty)
+{
+    switch (penalty)
+    {
+    case PageCross:
+        return "Page cross";
+    case BranchTaken:
+        return "Branch taken";
+    case BranchPageCross:
+        return "Branch page cross";
+    case Decimal:
+        return "Decimal mode";
+    default:
+        break;
+    }
+    return "";
+}
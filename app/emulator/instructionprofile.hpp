@@ -0,0 +1,87 @@
+#ifndef INSTRUCTIONPROFILE_HPP
+#define INSTRUCTIONPROFILE_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+
+/** Counts what the CPU executes and the extra cycles it pays for it.
+ *
+ *  Everything is counted per opcode, which is the only thing the CPU has to
+ *  index by when an instruction completes.  Totals per addressing mode and
+ *  per kind of penalty are summed up from those when the report is made.
+ */
+class InstructionProfile
+{
+public:
+    using counterType = uint64_t;
+
+    /// The reasons an instruction can take more than its base number of cycles.
+    enum Penalty
+    {
+        PageCross,       ///< An indexed address crossed into the next page
+        BranchTaken,     ///< A branch was taken
+        BranchPageCross, ///< A taken branch landed in a different page
+        Decimal,         ///< ADC or SBC in decimal mode
+        PenaltyCount
+    };
+
+    struct OpcodeCounters
+    {
+        counterType executed = 0;
+        counterType cycles = 0;    ///< Including the penalties
+        std::array<counterType, PenaltyCount> penalties{}; ///< In cycles
+    };
+
+    /** Counts one executed instruction.
+     *
+     *  @param opcode         The instruction executed
+     *  @param cycles         The total number of cycles it took
+     *  @param page_cross     The cycles added by its addressing mode crossing a page
+     *  @param branch_cycles  The cycles added by a branch: 1 if taken, 2 if it also crossed a page
+     *  @param decimal_cycles The cycles added by decimal mode
+     */
+    void count(uint8_t opcode, uint8_t cycles, uint8_t page_cross, uint8_t branch_cycles, uint8_t decimal_cycles)
+    {
+        OpcodeCounters &counters = _opcodes[opcode];
+
+        ++counters.executed;
+        counters.cycles += cycles;
+        counters.penalties[PageCross] += page_cross;
+        counters.penalties[BranchTaken] += (branch_cycles > 0);
+        counters.penalties[BranchPageCross] += (branch_cycles > 1);
+        counters.penalties[Decimal] += decimal_cycles;
+    }
+
+    const OpcodeCounters &opcode(uint8_t opcode) const { return _opcodes[opcode]; }
+
+    counterType executed() const;
+    counterType cycles() const;
+    counterType penalty(Penalty penalty) const;
+
+    void clear() { _opcodes = {}; }
+
+    /** Writes a report of the counters as text.
+     *
+     *  The report has the totals per penalty and per addressing mode, then the
+     *  instructions that lost the most cycles to page crossings, which are the
+     *  ones worth moving tables or loops around for.
+     *
+     *  @param output               The stream to write to
+     *  @param mnemonic_name        Gives the mnemonic of an opcode
+     *  @param addressing_mode_name Gives the name of the addressing mode of an opcode
+     */
+    void exportTo(std::ostream &output,
+                  const std::function<std::string (uint8_t)> &mnemonic_name,
+                  const std::function<std::string (uint8_t)> &addressing_mode_name) const;
+
+    static const char *PenaltyName(Penalty penalty);
+
+protected:
+    std::array<OpcodeCounters, 256> _opcodes;
+};
+
+#endif // INSTRUCTIONPROFILE_HPP
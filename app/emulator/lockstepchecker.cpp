@@ -0,0 +1,179 @@
+#include "lockstepchecker.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+
+
+LockstepChecker::LockstepChecker(std::unique_ptr<CpuBackend> reference, std::unique_ptr<CpuBackend> candidate, uint32_t interval)
+    :
+    _reference( std::move(reference) ),
+    _candidate( std::move(candidate) ),
+    _interval( std::max<uint32_t>(1, interval) )
+{
+}
+
+void LockstepChecker::start(const CpuState &state)
+{
+    _reference->setState( state );
+    _candidate->setState( state );
+    _checkpoint = state;
+    _instructions = 0;
+    _divergence.reset();
+}
+
+bool LockstepChecker::run(uint64_t cycles)
+{
+    if ( _divergence )
+        return false;
+
+    const uint64_t stop_cycles = _reference->cycles() + cycles;
+
+    while ( _reference->cycles() < stop_cycles )
+    {
+        uint32_t stepped = 0;
+
+        for ( ; (stepped < _interval) && (_reference->cycles() < stop_cycles); ++stepped)
+        {
+            _last_address = _reference->registers().program_counter;
+            _last_opcode = _reference->memory()[_last_address];
+            _reference->step();
+            _candidate->step();
+        }
+
+        if ( !agree() )
+        {
+            findDivergence();
+            return false;
+        }
+
+        _instructions += stepped;
+        if ( _interval > 1 )
+            _reference->getState( _checkpoint );
+    }
+    return true;
+}
+
+void LockstepChecker::report(std::ostream &output) const
+{
+    char buffer[96];
+
+    if ( !_divergence )
+    {
+        snprintf(buffer, sizeof(buffer), "Lockstep: %llu instructions agreed\n", static_cast<unsigned long long>(_instructions));
+        output << buffer;
+        return;
+    }
+
+    snprintf(buffer, sizeof(buffer), "Lockstep: diverged at instruction %llu, $%04X opcode $%02X\n",
+             static_cast<unsigned long long>(_divergence->instruction),
+             static_cast<unsigned int>(_divergence->address),
+             static_cast<unsigned int>(_divergence->opcode));
+    output << buffer << "  " << _divergence->differences << "\n";
+}
+
+bool LockstepChecker::agree() const
+{
+    const Registers &reference = _reference->registers();
+    const Registers &candidate = _candidate->registers();
+
+    return (reference.a == candidate.a) &&
+           (reference.x == candidate.x) &&
+           (reference.y == candidate.y) &&
+           (reference.stack_pointer == candidate.stack_pointer) &&
+           (reference.program_counter == candidate.program_counter) &&
+           (reference.status == candidate.status) &&
+           (_reference->cycles() == _candidate->cycles()) &&
+           (_reference->writeHash() == _candidate->writeHash());
+}
+
+std::string LockstepChecker::differences() const
+{
+    const Registers &reference = _reference->registers();
+    const Registers &candidate = _candidate->registers();
+    std::string text;
+    char buffer[80];
+
+    auto add = [&text](const char *difference)
+    {
+        if ( !text.empty() )
+            text += ", ";
+        text += difference;
+    };
+    auto compare = [&add, &buffer](const char *name, unsigned int reference_value, unsigned int candidate_value, int digits)
+    {
+        if ( reference_value == candidate_value )
+            return;
+        snprintf(buffer, sizeof(buffer), "%s: reference $%0*X, candidate $%0*X", name, digits, reference_value, digits, candidate_value);
+        add( buffer );
+    };
+
+    compare( "a", reference.a, candidate.a, 2 );
+    compare( "x", reference.x, candidate.x, 2 );
+    compare( "y", reference.y, candidate.y, 2 );
+    compare( "sp", reference.stack_pointer, candidate.stack_pointer, 2 );
+    compare( "pc", reference.program_counter, candidate.program_counter, 4 );
+    compare( "p", reference.status, candidate.status, 2 );
+
+    if ( _reference->cycles() != _candidate->cycles() )
+    {
+        snprintf(buffer, sizeof(buffer), "cycles: reference %llu, candidate %llu",
+                 static_cast<unsigned long long>(_reference->cycles()),
+                 static_cast<unsigned long long>(_candidate->cycles()));
+        add( buffer );
+    }
+
+    int listed = 0;
+
+    for (size_t address = 0; address < _reference->memory().size(); ++address)
+    {
+        if ( _reference->memory()[address] == _candidate->memory()[address] )
+            continue;
+
+        if ( ++listed > ListedMemoryDifferences )
+            continue;
+
+        char name[8];
+
+        snprintf(name, sizeof(name), "$%04X", static_cast<unsigned int>(address));
+        compare( name, _reference->memory()[address], _candidate->memory()[address], 2 );
+    }
+    if ( listed > ListedMemoryDifferences )
+    {
+        snprintf(buffer, sizeof(buffer), "%d more bytes of memory", listed - ListedMemoryDifferences);
+        add( buffer );
+    }
+    if ( text.empty() )
+        add( "only the order of the writes" );
+
+    return text;
+}
+
+void LockstepChecker::findDivergence()
+{
+    Divergence divergence;
+
+    divergence.instruction = _instructions;
+    divergence.address = _last_address;
+    divergence.opcode = _last_opcode;
+
+    if ( _interval > 1 )
+    {
+        // Go back to where they last agreed and find the first instruction that differs
+        _reference->setState( _checkpoint );
+        _candidate->setState( _checkpoint );
+        for (uint32_t stepped = 0; stepped < _interval; ++stepped)
+        {
+            divergence.instruction = _instructions;
+            divergence.address = _reference->registers().program_counter;
+            divergence.opcode = _reference->memory()[divergence.address];
+            _reference->step();
+            _candidate->step();
+            if ( !agree() )
+                break;
+            ++_instructions;
+        }
+    }
+
+    divergence.differences = differences();
+    _divergence = divergence;
+}
@@ -0,0 +1,78 @@
+#ifndef LOCKSTEPCHECKER_HPP
+#define LOCKSTEPCHECKER_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include "cpubackend.hpp"
+
+
+/** Runs two CPU backends side by side from the same state and stops at the
+ *  first instruction where they disagree.
+ *
+ *  After every @c interval instructions the registers, cycle counts and
+ *  running hashes of the writes are compared.  When they differ both backends
+ *  go back to the last state they agreed on and are stepped one instruction at
+ *  a time, comparing after each, to find the exact instruction that diverged.
+ *  An interval of 1 compares after every instruction and needs no going back.
+ */
+class LockstepChecker
+{
+public:
+    struct Divergence
+    {
+        uint64_t    instruction = 0; ///< How many instructions had agreed before this one
+        uint16_t    address = 0;     ///< Where the instruction that diverged is
+        uint8_t     opcode = 0;
+        std::string differences;     ///< What differed afterwards, such as "a: reference $12, candidate $13"
+    };
+
+    /** @param reference The backend to trust
+     *  @param candidate The backend being checked
+     *  @param interval  How many instructions to run between comparisons
+     */
+    LockstepChecker(std::unique_ptr<CpuBackend> reference, std::unique_ptr<CpuBackend> candidate, uint32_t interval);
+
+    /// Puts both backends in the same state and forgets any divergence
+    void start(const CpuState &state);
+
+    /** Runs both backends.
+     *
+     *  @param cycles Stop once the reference has run at least this many more cycles
+     *
+     *  @return false if the backends diverged
+     */
+    bool run(uint64_t cycles);
+
+    const std::optional<Divergence> &divergence() const { return _divergence; }
+
+    /// The number of instructions both backends have executed and agreed on
+    uint64_t instructions() const { return _instructions; }
+
+    const CpuBackend &reference() const { return *_reference; }
+    const CpuBackend &candidate() const { return *_candidate; }
+
+    /// Writes whether the backends agreed and, if not, where and how they differed
+    void report(std::ostream &output) const;
+
+protected:
+    /// How many differing bytes of memory are listed
+    static constexpr int ListedMemoryDifferences = 8;
+
+    std::unique_ptr<CpuBackend> _reference;
+    std::unique_ptr<CpuBackend> _candidate;
+    uint32_t                    _interval;
+    uint64_t                    _instructions = 0;
+    CpuState                    _checkpoint;
+    std::optional<Divergence>   _divergence;
+    uint16_t                    _last_address = 0; ///< Of the last instruction stepped
+    uint8_t                     _last_opcode = 0;
+
+    bool        agree() const;
+    std::string differences() const;
+    void        findDivergence();
+};
+
+#endif // LOCKSTEPCHECKER_HPP
@@ -0,0 +1,47 @@
+#include "machinesnapshot.hpp"
+#include "utilities/Profiling.hpp"
+#include <cstring>
+
+
+bool MachineSnapshot::changedSince(addressType first, addressType last, uint64_t since) const
+{
+    for (size_t page = first / PageSize; page <= last / PageSize; ++page)
+    {
+        if ( pageChangedSince( page, since ) )
+            return true;
+    }
+    return false;
+}
+
+void SnapshotBuffer::publish(const MachineSnapshot::memoryType &memory,
+                             const MachineSnapshot::pageGenerationsType &page_generations,
+                             uint64_t generation)
+{
+    PROFILE_FUNCTION();
+
+    MachineSnapshot &snapshot = back();
+
+    // Catch up on whatever changed since this snapshot was last filled in
+    for (size_t page = 0; page < MachineSnapshot::Pages; ++page)
+    {
+        if ( snapshot.page_generations[page] != page_generations[page] )
+        {
+            const size_t offset = page * MachineSnapshot::PageSize;
+
+            std::memcpy( &snapshot.memory[offset], &memory[offset], MachineSnapshot::PageSize );
+            snapshot.page_generations[page] = page_generations[page];
+        }
+    }
+    snapshot.generation = generation;
+
+    _back = _latest.exchange( _back | Fresh, std::memory_order_acq_rel ) & Index;
+}
+
+bool SnapshotBuffer::acquire()
+{
+    if ( !(_latest.load( std::memory_order_relaxed ) & Fresh) )
+        return false;
+
+    _front = _latest.exchange( _front, std::memory_order_acq_rel ) & Index;
+    return true;
+}
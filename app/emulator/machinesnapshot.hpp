@@ -0,0 +1,105 @@
+#ifndef MACHINESNAPSHOT_HPP
+#define MACHINESNAPSHOT_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "registers.hpp"
+#include "usagemonitor.hpp"
+
+
+/** A copy of everything the views show of a running machine.
+ *
+ *  Each page of memory carries the generation it last changed in, as kept
+ *  by RamBusDevice, so a view can tell whether what it drew from an earlier
+ *  snapshot (or from the memory itself) is still current without comparing
+ *  any bytes.
+ */
+struct MachineSnapshot
+{
+    using addressType = uint16_t;
+    using memoryType  = std::array<uint8_t, 64 * 1024>;
+    using pageGenerationsType = std::array<uint64_t, 256>;
+
+    static constexpr size_t PageSize = 256;
+    static constexpr size_t Pages = 256;
+
+    uint64_t     generation = 0;        ///< The generation of memory it holds
+    Registers    registers;
+    uint64_t     clock_ticks = 0;
+    uint64_t     instruction_count = 0;
+    UsageMonitor usage_monitor;
+    std::chrono::steady_clock::duration run_time{}; ///< Host time spent running the CPU, in total
+    bool         running = false;       ///< false in the last snapshot of a run, once it has stopped
+    memoryType   memory{};
+    pageGenerationsType page_generations{};
+
+    /// Tells whether a page has changed since generation @p since.
+    bool pageChangedSince(size_t page, uint64_t since) const { return page_generations[page] > since; }
+
+    /// Tells whether any page holding a byte from @p first to @p last has changed since generation @p since.
+    bool changedSince(addressType first, addressType last, uint64_t since) const;
+};
+
+/** Hands snapshots from the thread running the machine to the UI thread.
+ *
+ *  Three snapshots are kept: the one being filled in, the one most recently
+ *  published and the one being drawn.  Publishing swaps the first two and
+ *  taking the latest swaps the last two, each with a single atomic exchange,
+ *  so neither thread ever waits for the other.  Snapshots that are published
+ *  faster than they are taken are simply replaced.
+ *
+ *  Only the pages that changed are copied: a snapshot being reused only
+ *  needs the pages whose generation has moved on since it was last filled in.
+ */
+class SnapshotBuffer
+{
+public:
+    /** @name Producer
+     *  Only to be called from the thread running the machine.
+     */
+    ///@{
+    /// The snapshot to fill in before the next @c publish().  Its memory is filled in by @c publish().
+    MachineSnapshot &back() { return _snapshots[_back]; }
+
+    /** Publishes the snapshot filled in, with a copy of @p memory.
+     *
+     *  @param memory           The whole of memory as it is now
+     *  @param page_generations The generation each page of it was last written in
+     *  @param generation       The generation of memory as a whole
+     */
+    void publish(const MachineSnapshot::memoryType &memory,
+                 const MachineSnapshot::pageGenerationsType &page_generations,
+                 uint64_t generation);
+
+    /// Tells whether the last snapshot published has been taken, so it is worth publishing another.
+    bool consumed() const { return !(_latest.load( std::memory_order_acquire ) & Fresh); }
+    ///@}
+
+    /** @name Consumer
+     *  Only to be called from the UI thread.
+     */
+    ///@{
+    /** Takes the most recently published snapshot, if there is a newer one.
+     *
+     *  @return true if @c front() is now a newer snapshot
+     */
+    bool acquire();
+
+    /// The snapshot taken last.  It stays put until the next @c acquire().
+    const MachineSnapshot &front() const { return _snapshots[_front]; }
+    ///@}
+
+protected:
+    static constexpr uint8_t Index = 0x03;
+    static constexpr uint8_t Fresh = 0x04; ///< The latest hasn't been taken yet
+
+    std::array<MachineSnapshot, 3> _snapshots;
+    uint8_t                        _back = 0;     ///< Only used by the producer
+    std::atomic<uint8_t>           _latest{ 1 };  ///< Index of the latest published, plus Fresh
+    uint8_t                        _front = 2;    ///< Only used by the consumer
+};
+
+#endif // MACHINESNAPSHOT_HPP
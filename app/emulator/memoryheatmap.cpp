@@ -0,0 +1,67 @@
+#include "memoryheatmap.hpp"
+#include <algorithm>
+#include <cstdio>
+
+
+MemoryHeatmap::MemoryHeatmap()
+{
+    clear();
+}
+
+MemoryHeatmap::counterType MemoryHeatmap::pageMaximum(Access access, int page) const
+{
+    const addressType page_begin = static_cast<addressType>((page & 0xFF) << 8);
+    counterType maximum = 0;
+
+    for (int offset = 0; offset < 256; ++offset)
+        maximum = std::max( maximum, count( access, page_begin + offset ) );
+    return maximum;
+}
+
+void MemoryHeatmap::clear()
+{
+    for (auto &iCurrentCounters : _counters)
+    {
+        for (auto &iCurrentCounter : iCurrentCounters)
+            iCurrentCounter.store( 0, std::memory_order_relaxed );
+    }
+}
+
+void MemoryHeatmap::exportTo(std::ostream &output) const
+{
+    char buffer[64];
+
+    output << "address,execute,read,write\n";
+    for (size_t address = 0; address < _counters[Execute].size(); ++address)
+    {
+        const counterType executes = count( Execute, static_cast<addressType>(address) );
+        const counterType reads    = count( Read, static_cast<addressType>(address) );
+        const counterType writes   = count( Write, static_cast<addressType>(address) );
+
+        if ( (executes | reads | writes) == 0 )
+            continue;
+
+        snprintf(buffer, sizeof(buffer), "$%04X,%u,%u,%u\n",
+                 static_cast<unsigned int>(address),
+                 static_cast<unsigned int>(executes),
+                 static_cast<unsigned int>(reads),
+                 static_cast<unsigned int>(writes));
+        output << buffer;
+    }
+}
+
+const char *MemoryHeatmap::AccessName(Access access)
+{
+    switch (access)
+    {
+    case Execute:
+        return "Execute";
+    case Read:
+        return "Read";
+    case Write:
+        return "Write";
+    default:
+        break;
+    }
+    return "";
+}
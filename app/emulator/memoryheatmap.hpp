@@ -0,0 +1,79 @@
+#ifndef MEMORYHEATMAP_HPP
+#define MEMORYHEATMAP_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+
+/** Per-byte access counters for the whole 64KB address space.
+ *
+ *  Instruction fetches (opcode and operand bytes) are counted separately
+ *  from data reads and data writes.  Each kind of access lives in its own
+ *  dense array so that counting an access only ever touches one cache line.
+ *
+ *  The memory page overlay reads the counters while the emulation thread is
+ *  counting, so like the session statistics they are only ever changed by
+ *  that thread, with a relaxed load and store that costs no more than a
+ *  plain increment.
+ */
+class MemoryHeatmap
+{
+public:
+    using addressType  = uint16_t;
+    using counterType  = uint32_t;
+    using countersType = std::array<std::atomic<counterType>, 64 * 1024>;
+
+    enum Access
+    {
+        Execute, ///< Instruction fetches
+        Read,    ///< Data reads
+        Write,   ///< Data writes
+        AccessCount
+    };
+
+    MemoryHeatmap();
+
+    void countExecute(addressType address) { Increment( _counters[Execute][address] ); }
+    void countRead(addressType address)    { Increment( _counters[Read][address] ); }
+    void countWrite(addressType address)   { Increment( _counters[Write][address] ); }
+
+    const countersType &counters(Access access) const { return _counters[access]; }
+
+    counterType count(Access access, addressType address) const { return _counters[access][address].load( std::memory_order_relaxed ); }
+
+    /** Finds the largest counter within a single page.
+     *
+     *  @param access The kind of access to look at
+     *  @param page   The page number (high byte of the address)
+     *
+     *  @return The largest count of any byte in the page
+     */
+    counterType pageMaximum(Access access, int page) const;
+
+    /** Sets all the counters back to zero.
+     */
+    void clear();
+
+    /** Writes every address that has been touched as CSV.
+     *
+     *  The columns are "address,execute,read,write".  Addresses
+     *  that were never accessed are skipped.
+     *
+     *  @param output The stream to write to
+     */
+    void exportTo(std::ostream &output) const;
+
+    static const char *AccessName(Access access);
+
+protected:
+    std::array<countersType, AccessCount> _counters;
+
+    static void Increment(std::atomic<counterType> &counter)
+    {
+        counter.store( counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed );
+    }
+};
+
+#endif // MEMORYHEATMAP_HPP
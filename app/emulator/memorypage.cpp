@@ -2,6 +2,7 @@
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/event.hpp"
 #include "pageview.hpp"
+#include <cstdio>
 #include <utility>
 
 using namespace ftxui;
@@ -79,6 +80,10 @@ protected:
     bool OnMouseEvent(Event &event);
     bool OnEditModeEvent(Event &event);
     void OnFocusChanged(bool new_focus_state);
+
+    PageViewOverlay overlay();
+    Element writeProvenance();
+    void cycleHeatmapOverlay();
 };
 
 MemoryPageComponent::MemoryPageComponent(Ref<MemoryPageOption> option)
@@ -92,13 +97,61 @@ Element MemoryPageComponent::OnRender()
     if ( Focused() != _was_focused )
         OnFocusChanged( Focused() );
 
+    Element page;
+
     if ( Focused() )
-        return pageview( _option->model,
+        page = pageview( _option->model,
                          Ref<int>(&_option->current_byte()),
                          Ref<int>(&_option->show_pc()),
-                         _edit_mode ) | reflect(_box);
+                         _edit_mode,
+                         overlay(),
+                         _option->watchpoints ) | reflect(_box);
     else
-        return pageview( _option->model, Ref<int>(-1), Ref<int>(&_option->show_pc()), _edit_mode ) | reflect(_box);
+        page = pageview( _option->model, Ref<int>(-1), Ref<int>(&_option->show_pc()), _edit_mode, overlay(), _option->watchpoints ) | reflect(_box);
+
+    if ( !_option->write_provenance )
+        return page;
+
+    return vbox({ page, writeProvenance() });
+}
+
+Element MemoryPageComponent::writeProvenance()
+{
+    char buffer[64];
+
+    if ( !Focused() || (currentByte() == -1) )
+        return text("Recording writes");
+
+    IBusDevice::addressType address = (_option->model->page() << 8) | currentByte();
+
+    if ( _option->write_provenance->written( address ) )
+        snprintf(buffer, sizeof(buffer), "$%04X written by $%04X at %llu",
+                 static_cast<unsigned int>(address),
+                 static_cast<unsigned int>(_option->write_provenance->writer( address )),
+                 static_cast<unsigned long long>(_option->write_provenance->cycle( address )));
+    else
+        snprintf(buffer, sizeof(buffer), "$%04X not written", static_cast<unsigned int>(address));
+
+    return text(buffer);
+}
+
+PageViewOverlay MemoryPageComponent::overlay()
+{
+    if ( !_option->heatmap || (_option->heatmap_overlay() == MemoryPageOption::NoOverlay) )
+        return {};
+
+    return { _option->heatmap, static_cast<MemoryHeatmap::Access>( _option->heatmap_overlay() ) };
+}
+
+void MemoryPageComponent::cycleHeatmapOverlay()
+{
+    int next_overlay = _option->heatmap_overlay() + 1;
+
+    if ( next_overlay >= MemoryHeatmap::AccessCount )
+        next_overlay = MemoryPageOption::NoOverlay;
+
+    _option->heatmap_overlay() = next_overlay;
+    _option->on_heatmap_overlay_change();
 }
 
 void MemoryPageComponent::OnFocusChanged(bool new_focus_state)
@@ -195,6 +248,36 @@ bool MemoryPageComponent::OnEvent(Event event)
             _edit_mode = true;
             return true;
         }
+        else if (event == Event::Character('h'))
+        {
+            cycleHeatmapOverlay();
+            return true;
+        }
+        else if (event == Event::Character('x'))
+        {
+            _option->on_heatmap_export();
+            return true;
+        }
+        else if (event == Event::Character('p'))
+        {
+            _option->on_write_provenance_toggle();
+            return true;
+        }
+        else if (event == Event::Character('P'))
+        {
+            _option->on_write_provenance_export();
+            return true;
+        }
+        else if ( (event == Event::Character('r')) || (event == Event::Character('w')) )
+        {
+            if ( currentByte() == -1 )
+                return false;
+
+            IBusDevice::addressType address = (_option->model->page() << 8) | currentByte();
+
+            _option->on_toggle_watchpoint( address, (event == Event::Character('r')) ? Breakpoints::Read : Breakpoints::Write );
+            return true;
+        }
     }
 
     return false;
@@ -235,18 +318,18 @@ bool MemoryPageComponent::OnEditModeEvent(Event &event)
     {
         // Decrement memory location
         IBusDevice::addressType address = (_option->model->page() << 8) | currentByte();
-        RamBusDevice::memory_type::value_type new_value = _option->model->model()->memory().at( address ) - 1;
+        RamBusDevice::memory_type::value_type new_value = _option->model->memory().at( address ) - 1;
 
-        _option->model->model()->write( address, new_value );
+        _option->on_edit( address, new_value );
         return true;
     }
     else if ( (event == Event::ArrowRight) || (event == Event::ArrowUp) )
     {
         // Increment memory location
         IBusDevice::addressType address = (_option->model->page() << 8) | currentByte();
-        RamBusDevice::memory_type::value_type new_value = _option->model->model()->memory().at( address ) + 1;
+        RamBusDevice::memory_type::value_type new_value = _option->model->memory().at( address ) + 1;
 
-        _option->model->model()->write( address, new_value );
+        _option->on_edit( address, new_value );
         return true;
     }
     else if (event == Event::PageUp)
@@ -4,14 +4,41 @@
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/event.hpp"
 #include "emulator/rambusdeviceview.hpp"
+#include "emulator/memoryheatmap.hpp"
+#include "emulator/breakpoints.hpp"
+#include "emulator/writeprovenance.hpp"
+#include <functional>
 #include <memory>
 
 struct MemoryPageOption
 {
+    static constexpr int NoOverlay = -1;
+
     std::shared_ptr<RamBusDeviceView> model;
     ftxui::Ref<int>                   current_byte = -1;
     ftxui::Ref<int>                   show_pc = -1;
     ftxui::Ref<ftxui::Event>          previous_event;
+
+    /// Called with an address and the value it has been edited to, to write it.
+    std::function<void(IBusDevice::addressType, uint8_t)> on_edit = [](IBusDevice::addressType, uint8_t) {};
+
+    const MemoryHeatmap              *heatmap = nullptr;
+    ftxui::Ref<int>                   heatmap_overlay = NoOverlay; // Otherwise a MemoryHeatmap::Access
+
+    /// Called when the heatmap overlay is cycled through.
+    std::function<void()> on_heatmap_overlay_change = [] {};
+    /// Called when the user asks for the heatmap to be exported.
+    std::function<void()> on_heatmap_export = [] {};
+
+    const Breakpoints                *watchpoints = nullptr;
+    /// Called with the selected address and the kind of watchpoint (Read or Write) to toggle.
+    std::function<void(IBusDevice::addressType, Breakpoints::Kind)> on_toggle_watchpoint = [](IBusDevice::addressType, Breakpoints::Kind) {};
+
+    const WriteProvenance            *write_provenance = nullptr; // Only set while writes are being recorded
+    /// Called when the recording of who wrote each byte is turned on or off.
+    std::function<void()> on_write_provenance_toggle = [] {};
+    /// Called when the user asks for the write provenance to be exported.
+    std::function<void()> on_write_provenance_export = [] {};
 };
 
 ftxui::Component MemoryPage(ftxui::Ref<MemoryPageOption> option);
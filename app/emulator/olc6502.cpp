@@ -90,27 +90,33 @@ olc6502::olc6502(QObject *parent)
              },
              [this](InstructionExecutor::registerType new_value)
              {
-                 emit aChanged(new_value);
+                 if ( _change_signals_enabled )
+                     emit aChanged(new_value);
              },
              [this](InstructionExecutor::registerType new_value)
              {
-                 emit xChanged(new_value);
+                 if ( _change_signals_enabled )
+                     emit xChanged(new_value);
              },
              [this](InstructionExecutor::registerType new_value)
              {
-                 emit yChanged(new_value);
+                 if ( _change_signals_enabled )
+                     emit yChanged(new_value);
              },
              [this](InstructionExecutor::addressType new_value)
              {
-                 emit pcChanged(new_value);
+                 if ( _change_signals_enabled )
+                     emit pcChanged(new_value);
              },
              [this](InstructionExecutor::registerType new_value)
              {
-                 emit stackPointerChanged(new_value);
+                 if ( _change_signals_enabled )
+                     emit stackPointerChanged(new_value);
              },
              [this](InstructionExecutor::registerType new_value)
              {
-                 emit statusChanged(new_value);
+                 if ( _change_signals_enabled )
+                     emit statusChanged(new_value);
              }
            }
 {
@@ -190,6 +196,11 @@ auto olc6502::disassemble(addressType start, addressType stop) const -> disassem
     return _executor.disassemble(start, stop);
 }
 
+auto olc6502::disassemble(addressType start, addressType stop, const InstructionExecutor::readDelegate &read_memory) const -> disassemblyType
+{
+    return _executor.disassemble(start, stop, read_memory);
+}
+
 olc6502::addressType olc6502::beginExecutingAtAddressAfterReset() const
 {
     return static_cast<addressType>(read( ResetJumpStartAddress )) |
@@ -115,6 +115,9 @@ public:
     // clocking every cycle
     bool complete() const;
 
+    // The opcode of the instruction being executed, or of the last one once it has completed
+    uint8_t opcode() const { return _executor.opcode(); }
+
     uint8_t a() const { return _registers.a; }
     uint8_t x() const { return _registers.x; }
     uint8_t y() const { return _registers.y; }
@@ -126,12 +129,51 @@ public:
     const Registers &registers() const { return _registers; }
           Registers &registers()       { return _registers; }
 
-    uint32_t clockTicks() const { return _executor.clock_ticks; }
+    uint64_t clockTicks() const { return _executor.clock_ticks; }
+    uint64_t instructionCount() const { return _executor.instruction_count; }
+    uint64_t stateHash() const { return _executor.stateHash(); }
 
     bool log() const { return _log; }
     void setLog(bool value);
 
     auto disassemble(addressType start, addressType stop) const -> disassemblyType;
+    auto disassemble(addressType start, addressType stop, const InstructionExecutor::readDelegate &read_memory) const -> disassemblyType;
+
+    // Whether the registers signal their changes.  Turned off while the
+    // CPU runs on a thread of its own, where nothing is listening.
+    bool changeSignalsEnabled() const { return _change_signals_enabled; }
+    void setChangeSignalsEnabled(bool enabled) { _change_signals_enabled = enabled; }
+
+    MemoryHeatmap *heatmap() const { return _executor.heatmap(); }
+    void setHeatmap(MemoryHeatmap *heatmap) { _executor.setHeatmap(heatmap); }
+
+    Breakpoints *watchpoints() const { return _executor.watchpoints(); }
+    void setWatchpoints(Breakpoints *watchpoints) { _executor.setWatchpoints(watchpoints); }
+
+    WriteProvenance *writeProvenance() const { return _executor.writeProvenance(); }
+    void setWriteProvenance(WriteProvenance *write_provenance) { _executor.setWriteProvenance(write_provenance); }
+
+    SessionStatistics *statistics() const { return _executor.statistics(); }
+    void setStatistics(SessionStatistics *statistics) { _executor.setStatistics(statistics); }
+
+    bool stopOnBrk() const { return _executor.stopOnBrk(); }
+    void setStopOnBrk(bool stop) { _executor.setStopOnBrk(stop); }
+    bool brkExecuted() const { return _executor.brkExecuted(); }
+    void acknowledgeBrk() { _executor.acknowledgeBrk(); }
+
+    bool directPages() const { return _executor.directPages(); }
+    void setDirectPages(uint8_t *data, uint64_t *dirty_pages) { _executor.setDirectPages(data, dirty_pages); }
+
+    const UsageMonitor &usageMonitor() const { return _executor.usageMonitor(); }
+
+    const FlightRecorder &flightRecorder() const { return _executor.flightRecorder(); }
+          FlightRecorder &flightRecorder()       { return _executor.flightRecorder(); }
+
+    const std::string &mnemonic(uint8_t opcode) const { return _executor.mnemonic(opcode); }
+    std::string addressingMode(uint8_t opcode) const { return _executor.addressingMode(opcode); }
+
+    InstructionProfile *profile() const { return _executor.profile(); }
+    void setProfile(InstructionProfile *profile) { _executor.setProfile(profile); }
 
     addressType beginExecutingAtAddressAfterReset() const;
 
@@ -168,6 +210,7 @@ private:
     Registers _registers;
     InstructionExecutor _executor;
     bool     _log = false;
+    bool     _change_signals_enabled = true;
 
     // These only exist to get around the QML type system.  It only really knows about
     // int, which is OK because in this case, all unsigned 8-bit values exist within the
@@ -2,6 +2,7 @@
 #include "ftxui/screen/color.hpp"
 #include "ftxui/util/ref.hpp"
 #include "ftxui/dom/elements.hpp"
+#include "utilities/Profiling.hpp"
 #include <utility>
 #include <array>
 #include <iterator>
@@ -46,6 +47,19 @@ std::string PageNumberAsString(int page_number)
     return { buffer, 2 };
 }
 
+std::string OverlayAsString(const PageViewOverlay &overlay)
+{
+    if ( !overlay.heatmap )
+        return {};
+
+    return std::string(" [") + MemoryHeatmap::AccessName( overlay.access ) + "]";
+}
+
+Color HeatColor(float intensity)
+{
+    return Color::Interpolate( intensity, Color::RGB(64, 0, 0), Color::RGB(255, 192, 0) );
+}
+
 }
 
 class PageView : public Node
@@ -54,7 +68,9 @@ public:
     PageView(std::shared_ptr<RamBusDeviceView> model,
              Ref<int>  current_byte,
              Ref<int>  program_counter,
-             bool      in_edit_mode);
+             bool      in_edit_mode,
+             PageViewOverlay overlay,
+             const Breakpoints *watchpoints);
 
     void ComputeRequirement() override;
 
@@ -67,6 +83,8 @@ protected:
     Ref<int>                          _program_counter;
     Element                           _display;
     bool                              _in_edit_mode;
+    PageViewOverlay                   _overlay;
+    const Breakpoints                *_watchpoints;
 
     std::string byteAsString(int line, int column) const;
 
@@ -76,7 +94,7 @@ protected:
         size_t line_index = page_index + line * 16;
         size_t index = line_index + static_cast<size_t>(column);
 
-        return _model->model()->memory()[ index ];
+        return _model->memory()[ index ];
     }
 
     Elements generateLineWidgets(int line) const
@@ -96,17 +114,23 @@ protected:
     void affectCurrentByteInEditMode(Screen &screen, const Box &box);
     void affectCurrentByteInNonEditMode(Screen &screen, const Box &box);
     void affectCurrentProgramCounter(Screen &screen, const Box &box);
+    void affectHeatmapOverlay(Screen &screen);
+    void affectWatchpoints(Screen &screen);
 };
 
 PageView::PageView(std::shared_ptr<RamBusDeviceView> model,
                    Ref<int>       current_byte,
                    Ref<int>       show_pc,
-                   bool           in_edit_mode)
+                   bool           in_edit_mode,
+                   PageViewOverlay overlay,
+                   const Breakpoints *watchpoints)
     :
     _model{ std::move(model) },
     _current_byte_in_page{ std::move(current_byte) },
     _program_counter{ std::move(show_pc) },
-    _in_edit_mode{ in_edit_mode }
+    _in_edit_mode{ in_edit_mode },
+    _overlay{ overlay },
+    _watchpoints{ watchpoints }
 {
     std::vector<Elements> grid_rows;
 
@@ -116,12 +140,12 @@ PageView::PageView(std::shared_ptr<RamBusDeviceView> model,
 
     if ( _in_edit_mode )
     {
-        children_.emplace_back( window( hbox({ text(" Memory Page: "), text( PageNumberAsString(_model->page()) ) }),
+        children_.emplace_back( window( hbox({ text(" Memory Page: "), text( PageNumberAsString(_model->page()) ), text( OverlayAsString(_overlay) ) }),
                                         dim( gridbox( std::move(grid_rows) ) ) ) );
     }
     else
     {
-        children_.emplace_back( window( hbox({ text(" Memory Page: "), text( PageNumberAsString(_model->page()) ) }),
+        children_.emplace_back( window( hbox({ text(" Memory Page: "), text( PageNumberAsString(_model->page()) ), text( OverlayAsString(_overlay) ) }),
                                         gridbox( std::move(grid_rows) ) ) );
     }
 }
@@ -140,8 +164,16 @@ void PageView::SetBox(Box box)
 
 void PageView::Render(Screen &screen)
 {
+    PROFILE_ZONE("PageView::Render");
+
     Node::Render(screen);
 
+    if ( _overlay.heatmap )
+        affectHeatmapOverlay( screen );
+
+    if ( _watchpoints && _watchpoints->anyWatchpoints() )
+        affectWatchpoints( screen );
+
     // Show the PC if necessary...
     if (_current_byte_in_page() != -1)
     {
@@ -197,9 +229,60 @@ void PageView::affectCurrentProgramCounter(Screen &screen, const Box &pc)
     screen.PixelAt( box_.x_min + pc.x_min + 1, box_.y_min + pc.y_min ).background_color = Color::Blue;
 }
 
-Element pageview(std::shared_ptr<RamBusDeviceView> model, Ref<int> current_byte, Ref<int> program_counter, bool in_edit_mode)
+void PageView::affectHeatmapOverlay(Screen &screen)
+{
+    const int page = _model->page();
+    const MemoryHeatmap::counterType maximum = _overlay.heatmap->pageMaximum( _overlay.access, page );
+
+    if ( maximum == 0 )
+        return;
+
+    for (int byte = 0; byte < 256; ++byte)
+    {
+        MemoryHeatmap::counterType count = _overlay.heatmap->count( _overlay.access, static_cast<MemoryHeatmap::addressType>((page << 8) | byte) );
+
+        if ( count == 0 )
+            continue;
+
+        Box   cell  = pageview_ui_box_for_byte( byte );
+        Color color = HeatColor( static_cast<float>(count) / static_cast<float>(maximum) );
+
+        // Translate to global coords and draw...
+        screen.PixelAt( box_.x_min + cell.x_min    , box_.y_min + cell.y_min ).background_color = color;
+        screen.PixelAt( box_.x_min + cell.x_min + 1, box_.y_min + cell.y_min ).background_color = color;
+    }
+}
+
+void PageView::affectWatchpoints(Screen &screen)
+{
+    const int page = _model->page();
+
+    for (int byte = 0; byte < 256; ++byte)
+    {
+        Breakpoints::addressType address = static_cast<Breakpoints::addressType>((page << 8) | byte);
+        bool read  = _watchpoints->test( Breakpoints::Read, address );
+        bool write = _watchpoints->test( Breakpoints::Write, address );
+
+        if ( !read && !write )
+            continue;
+
+        Box   cell  = pageview_ui_box_for_byte( byte );
+        Color color = (read && write) ? Color::Red : (read ? Color::Cyan : Color::Magenta);
+
+        // Translate to global coords and draw...
+        for (int x = cell.x_min; x <= cell.x_max; ++x)
+        {
+            Pixel &pixel = screen.PixelAt( box_.x_min + x, box_.y_min + cell.y_min );
+
+            pixel.foreground_color = color;
+            pixel.bold = true;
+        }
+    }
+}
+
+Element pageview(std::shared_ptr<RamBusDeviceView> model, Ref<int> current_byte, Ref<int> program_counter, bool in_edit_mode, PageViewOverlay overlay, const Breakpoints *watchpoints)
 {
-    return std::make_shared<PageView>( std::move(model), std::move(current_byte), std::move(program_counter), in_edit_mode );
+    return std::make_shared<PageView>( std::move(model), std::move(current_byte), std::move(program_counter), in_edit_mode, overlay, watchpoints );
 }
 
 int pageview_byte(int x_coord, int y_coord)
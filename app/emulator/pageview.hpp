@@ -5,13 +5,28 @@
 #include "ftxui/dom/elements.hpp"
 #include "ftxui/util/ref.hpp"
 #include "rambusdeviceview.hpp"
+#include "memoryheatmap.hpp"
+#include "breakpoints.hpp"
 #include <memory>
 
 
+/** Colors each byte by how often it has been accessed.
+ *
+ *  The intensity is relative to the most accessed byte in the page
+ *  being displayed.
+ */
+struct PageViewOverlay
+{
+    const MemoryHeatmap  *heatmap = nullptr; ///< No overlay is drawn when this is nullptr
+    MemoryHeatmap::Access access  = MemoryHeatmap::Read;
+};
+
 ftxui::Element pageview(std::shared_ptr<RamBusDeviceView> model,
                         ftxui::Ref<int>                   current_byte,
                         ftxui::Ref<int>                   program_counter,
-                        bool                              in_edit_mode);
+                        bool                              in_edit_mode,
+                        PageViewOverlay                   overlay = {},
+                        const Breakpoints                *watchpoints = nullptr);
 
 int pageview_byte(int x_coord, int y_coord);
 
@@ -1,5 +1,6 @@
 #include "rambusdevice.hpp"
 #include <algorithm>
+#include <cstring>
 
 
 RamBusDevice::RamBusDevice()
@@ -13,10 +14,53 @@ RamBusDevice::~RamBusDevice()
 {
 }
 
+void RamBusDevice::edit(addressType address, uint8_t data)
+{
+    write(address, data);
+    emit memoryChanged(address, data);
+}
+
+uint64_t RamBusDevice::collectChanges()
+{
+    bool changed = false;
+
+    for (size_t iCurrentWord = 0; iCurrentWord < _dirty_pages.size(); ++iCurrentWord)
+    {
+        const uint64_t dirty = _dirty_pages[iCurrentWord];
+
+        if ( !dirty )
+            continue;
+
+        if ( !changed )
+        {
+            ++_generation;
+            changed = true;
+        }
+
+        for (size_t bit = 0; bit < 64; ++bit)
+        {
+            if ( dirty & (uint64_t(1) << bit) )
+                _page_generations[iCurrentWord * 64 + bit] = _generation;
+        }
+        _dirty_pages[iCurrentWord] = 0;
+    }
+    return _generation;
+}
+
+bool RamBusDevice::changedSince(addressType first, addressType last, uint64_t since) const
+{
+    for (size_t page = first >> 8; page <= size_t(last >> 8); ++page)
+    {
+        if ( _page_generations[page] > since )
+            return true;
+    }
+    return false;
+}
+
 void RamBusDevice::writeImplementation(uint16_t address, uint8_t data)
 {
     _data[address] = data;
-    emit memoryChanged(address, data);
+    _dirty_pages[address >> 14] |= uint64_t(1) << ((address >> 8) & 0x3F);
 }
 
 uint8_t RamBusDevice::readImplementation(uint16_t address, bool read_only)
@@ -25,3 +69,39 @@ uint8_t RamBusDevice::readImplementation(uint16_t address, bool read_only)
 
     return _data[address];
 }
+
+void RamBusDevice::readBlockImplementation(uint16_t address, uint8_t *data, size_t size, bool read_only)
+{
+    Q_UNUSED(read_only);
+
+    std::memcpy( data, &_data[address], size );
+}
+
+void RamBusDevice::writeBlockImplementation(uint16_t address, const uint8_t *data, size_t size)
+{
+    std::memcpy( &_data[address], data, size );
+    markDirty( address, size );
+}
+
+void RamBusDevice::fillImplementation(uint16_t address, size_t size, uint8_t value)
+{
+    std::memset( &_data[address], value, size );
+    markDirty( address, size );
+}
+
+void RamBusDevice::copyImplementation(uint16_t destination, uint16_t source, size_t size)
+{
+    std::memmove( &_data[destination], &_data[source], size );
+    markDirty( destination, size );
+}
+
+void RamBusDevice::markDirty(uint16_t address, size_t size)
+{
+    if ( size == 0 )
+        return;
+
+    const size_t last_page = (address + size - 1) >> 8;
+
+    for (size_t page = address >> 8; page <= last_page; ++page)
+        _dirty_pages[page >> 6] |= uint64_t(1) << (page & 0x3F);
+}
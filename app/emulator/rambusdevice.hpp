@@ -7,12 +7,21 @@
 
 /** Represents a contiguous block of RAM.
  *
+ *  Writes made by the CPU aren't signalled, as there are far too many of
+ *  them.  Instead each one marks its page in a bitmap of dirty pages, and
+ *  whoever has the memory calls @c collectChanges() once in a while (say once
+ *  a frame) to turn the bitmap into a generation for every page.  Anything
+ *  drawn from memory can then tell whether it is out of date by comparing
+ *  the generations of its pages against the generation it was drawn at.
+ *
+ *  Only @c edit(), for changes made by the user, emits @c memoryChanged().
  */
 class RamBusDevice : public IBusDevice
 {
     Q_OBJECT
 public:
     using memory_type = std::array<uint8_t, 64 * 1024>;
+    using page_generations_type = std::array<uint64_t, 256>;
 
     RamBusDevice();
    ~RamBusDevice() override;
@@ -26,19 +35,58 @@ public:
     */
    const memory_type &memory() const { return _data; }
 
+   /** Writes a byte on behalf of the user, as opposed to the CPU.
+    *
+    *  @param address The address to write to
+    *  @param data    The byte of data to write
+    *
+    *  @see memoryChanged
+    */
+   void edit(addressType address, uint8_t data);
+
+   /** Turns the pages written to since the last call into a new generation.
+    *
+    *  Only to be called by the thread using the memory.
+    *
+    *  @return The generation now, which is the same as before if nothing was written
+    */
+   uint64_t collectChanges();
+
+   /// The generation as of the last @c collectChanges().  Counts up from 0.
+   uint64_t generation() const { return _generation; }
+
+   /// The generation each page was last written in, as of the last @c collectChanges()
+   const page_generations_type &pageGenerations() const { return _page_generations; }
+
+   /// Tells whether any page holding a byte from @p first to @p last has changed since generation @p since.
+   bool changedSince(addressType first, addressType last, uint64_t since) const;
+
+   /** @name Direct access
+    *  For the CPU to reach a page without going through the bus.  A write
+    *  made this way has to set the page's bit in @c dirtyPages() itself, as
+    *  @c write() would, or @c collectChanges() won't see it.
+    */
+   ///@{
+   uint8_t  *data() { return _data.data(); }
+
+   /// The word of the dirty page bitmap holding @p address's page, which is bit (address >> 8) & 0x3F.
+   uint64_t *dirtyPages(addressType address) { return &_dirty_pages[address >> 14]; }
+   ///@}
+
 public slots:
 
 signals:
-    /** A signal representing what data was just written.
+    /** A signal representing what data the user just wrote.
      *
-     *  This is a pass-through of the @c write() method.
+     *  This is a pass-through of the @c edit() method.
      *  It's main purpose is to allow for another entity
-     *  to know when the underlying memory has changed.
+     *  to know when the user has changed the underlying memory.
+     *  Writes by the CPU are found through @c collectChanges() instead.
      *
      *  @param address The address to write to
      *  @param data    The byte of data to write
      *
-     *  @see write
+     *  @see edit
      */
     void memoryChanged(addressType address, uint8_t data);
 
@@ -46,8 +94,19 @@ protected:
     void    writeImplementation(addressType address, uint8_t data) override;
     uint8_t readImplementation(addressType address, bool read_only) override;
 
+    void readBlockImplementation(addressType address, uint8_t *data, size_t size, bool read_only) override;
+    void writeBlockImplementation(addressType address, const uint8_t *data, size_t size) override;
+    void fillImplementation(addressType address, size_t size, uint8_t value) override;
+    void copyImplementation(addressType destination, addressType source, size_t size) override;
+
+    /// Marks every page from @p address to @p address + @p size - 1 dirty, once each.
+    void markDirty(addressType address, size_t size);
+
 private:
     memory_type _data;
+    std::array<uint64_t, 4> _dirty_pages{};      ///< One bit per page written since the last collectChanges()
+    page_generations_type   _page_generations{};
+    uint64_t                _generation = 0;
 };
 
 #endif // RAMBUSDEVICE_HPP
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include "rambusdevice.hpp"
+#include "machinesnapshot.hpp"
 
 
 class RamBusDeviceView : public QObject
@@ -30,6 +31,21 @@ public:
      */
     void setModel(RamBusDevice *new_model);
 
+    /** Shows a snapshot of memory instead of the model itself.
+     *
+     *  This is for while the model is being run on another thread.
+     *
+     *  @param snapshot The snapshot to show, or nullptr to go back to showing the model
+     */
+    void setSnapshot(const MachineSnapshot *snapshot) { _snapshot = snapshot; }
+    const MachineSnapshot *snapshot() const { return _snapshot; }
+
+    /** Gives the memory to display.
+     *
+     *  @return The memory of the snapshot if there is one, otherwise of the model
+     */
+    const RamBusDevice::memory_type &memory() const { return _snapshot ? _snapshot->memory : _model->memory(); }
+
     /** Queries the current page to view.
      *
      *  @return The current page to view
@@ -60,6 +76,7 @@ signals:
     void memoryChanged(RamBusDevice::addressType address, uint8_t value);
 private:
     RamBusDevice  *_model = nullptr;
+    const MachineSnapshot *_snapshot = nullptr;
     int            _page  = 0x00;
 
 private slots:
@@ -4,6 +4,7 @@
 #include <functional>
 #include <array>
 #include <charconv>
+#include <cstdio>
 
 using namespace ftxui;
 
@@ -21,7 +22,7 @@ RegisterView::RegisterView(QObject *parent)
     _status_input = InputStatus(&_status_option);
     _input_a_option.on_change = [this]()
     {
-        if ( model() )
+        if ( model() && !_snapshot )
         {
             _model->registers().a = *_input_a_option.data;
         }
@@ -29,7 +30,7 @@ RegisterView::RegisterView(QObject *parent)
 
     _input_x_option.on_change = [this]()
     {
-        if ( model() )
+        if ( model() && !_snapshot )
         {
             _model->registers().x = *_input_x_option.data;
         }
@@ -37,7 +38,7 @@ RegisterView::RegisterView(QObject *parent)
 
     _input_y_option.on_change = [this]()
     {
-        if ( model() )
+        if ( model() && !_snapshot )
         {
             _model->registers().y = *_input_y_option.data;
         }
@@ -45,7 +46,7 @@ RegisterView::RegisterView(QObject *parent)
 
     _input_stack_pointer_option.on_change = [this]()
     {
-        if ( model() )
+        if ( model() && !_snapshot )
         {
             _model->registers().stack_pointer = *_input_stack_pointer_option.data;
         }
@@ -53,7 +54,7 @@ RegisterView::RegisterView(QObject *parent)
 
     _input_program_counter_option.on_change = [this]()
     {
-        if ( model() )
+        if ( model() && !_snapshot )
         {
             _model->registers().program_counter = *_input_program_counter_option.data;
         }
@@ -61,7 +62,7 @@ RegisterView::RegisterView(QObject *parent)
 
     _status_option.on_change = [this]()
     {
-        if ( model() )
+        if ( model() && !_snapshot )
             _model->registers().status = *_status_option.status;
     };
 }
@@ -84,6 +85,15 @@ void RegisterView::setModel(olc6502 *new_model)
     }
 }
 
+void RegisterView::setSnapshot(const MachineSnapshot *snapshot)
+{
+    _snapshot = snapshot;
+    if ( _snapshot )
+        showRegisters( _snapshot->registers );
+    else if ( model() )
+        generateContent();
+}
+
 Component RegisterView::component()
 {
     _inputs = Container::Vertical({
@@ -97,9 +107,34 @@ Component RegisterView::component()
     return Renderer( _inputs, std::bind( &RegisterView::generateView, this ) );
 }
 
+Element RegisterView::generateUsageView() const
+{
+    const UsageMonitor &monitor = _snapshot ? _snapshot->usage_monitor : model()->usageMonitor();
+    char stack_buffer[24];
+    char wraps_buffer[24];
+    char zero_page_buffer[24];
+
+    snprintf(stack_buffer, sizeof(stack_buffer), "Low SP: $%02X $%04X",
+             static_cast<unsigned int>(monitor.lowestStackPointer()),
+             static_cast<unsigned int>(monitor.lowestStackPointerAddress()));
+    snprintf(wraps_buffer, sizeof(wraps_buffer), "Over/Under: %u/%u",
+             static_cast<unsigned int>(monitor.stackOverflows()),
+             static_cast<unsigned int>(monitor.stackUnderflows()));
+    snprintf(zero_page_buffer, sizeof(zero_page_buffer), "ZP used: %u",
+             static_cast<unsigned int>(monitor.zeroPageCount()));
+
+    Element wraps = text(wraps_buffer);
+
+    if ( monitor.stackOverflows() || monitor.stackUnderflows() )
+        wraps = wraps | color(Color::Red);
+
+    return vbox({ text(stack_buffer), wraps, text(zero_page_buffer) });
+}
+
 Element RegisterView::generateView() const
 {
     return window( text("Registers") | hcenter,
+                   vbox({
                    hbox({
                        vbox({
                             text("A: "),
@@ -118,6 +153,9 @@ Element RegisterView::generateView() const
                             _status_input->Render()
                               | size(WIDTH, EQUAL , 8 + 7) | size(HEIGHT, EQUAL, 2)
                           })
+                  }),
+                   separator(),
+                   generateUsageView()
                   }) ) |
            size(WIDTH, EQUAL, 21);
 }
@@ -174,12 +212,17 @@ void RegisterView::connectModelSignals(olc6502 *m)
 
 void RegisterView::generateContent()
 {
-    onAChanged( model()->a() );
-    onXChanged( model()->x() );
-    onYChanged( model()->y() );
-    onStackPointerChanged( model()->stackPointer() );
-    onPCChanged( model()->pc() );
-    onStatusChanged( model()->status() );
+    showRegisters( model()->registers() );
+}
+
+void RegisterView::showRegisters(const Registers &registers)
+{
+    onAChanged( registers.a );
+    onXChanged( registers.x );
+    onYChanged( registers.y );
+    onStackPointerChanged( registers.stack_pointer );
+    onPCChanged( registers.program_counter );
+    onStatusChanged( registers.status );
 }
 
 void RegisterView::onAChanged(uint8_t new_value)
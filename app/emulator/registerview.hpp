@@ -4,6 +4,7 @@
 #include <QObject>
 #include "ui/components/inputnumber.hpp"
 #include "emulator/olc6502.hpp"
+#include "emulator/machinesnapshot.hpp"
 
 class RegisterView : public QObject
 {
@@ -27,6 +28,15 @@ public:
      */
     void setModel(olc6502 *new_model);
 
+    /** Shows the registers of a snapshot instead of the model itself.
+     *
+     *  This is for while the model is being run on another thread.  Editing
+     *  the registers has no effect until the model is shown again.
+     *
+     *  @param snapshot The snapshot to show, or nullptr to go back to showing the model
+     */
+    void setSnapshot(const MachineSnapshot *snapshot);
+
     bool editMode() const { return _edit_mode; }
     void toggleEditMode() { _edit_mode = !_edit_mode; }
 
@@ -41,6 +51,7 @@ signals:
 
 protected:
     olc6502          *_model = nullptr;
+    const MachineSnapshot *_snapshot = nullptr;
     InputByteOption   _input_a_option;
     InputByteOption   _input_x_option;
     InputByteOption   _input_y_option;
@@ -59,8 +70,10 @@ protected:
     void disconnectModelSignals(olc6502 *m);
     void connectModelSignals(olc6502 *m);
     void generateContent();
+    void showRegisters(const Registers &registers);
     std::vector<StatusOption::Mask> generate6502StatusMasks();
     ftxui::Element generateView() const;
+    ftxui::Element generateUsageView() const;
 
 private slots:
     void onAChanged(uint8_t new_value);
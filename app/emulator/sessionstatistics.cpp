@@ -0,0 +1,47 @@
+#include "sessionstatistics.hpp"
+#include <cstdio>
+
+
+SessionStatistics::SessionStatistics()
+{
+    Set( cycles, 0 );
+    Set( instructions, 0 );
+    Set( irqs, 0 );
+    Set( nmis, 0 );
+    Set( breakpoints_hit, 0 );
+    Set( watchpoints_hit, 0 );
+    for (counterType &iCurrentPage : page_writes)
+        Set( iCurrentPage, 0 );
+}
+
+void SessionStatistics::exportTo(std::ostream &output) const
+{
+    const std::pair<const char *, const counterType *> totals[] = {
+        { "cycles",          &cycles },
+        { "instructions",    &instructions },
+        { "irqs",            &irqs },
+        { "nmis",            &nmis },
+        { "breakpoints_hit", &breakpoints_hit },
+        { "watchpoints_hit", &watchpoints_hit } };
+    char buffer[96];
+
+    for (const auto &[name, counter] : totals)
+    {
+        snprintf(buffer, sizeof(buffer), "# TYPE emulator_%s_total counter\nemulator_%s_total %llu\n",
+                 name, name, static_cast<unsigned long long>( Get( *counter ) ));
+        output << buffer;
+    }
+
+    output << "# TYPE emulator_page_writes_total counter\n";
+    for (size_t page = 0; page < page_writes.size(); ++page)
+    {
+        const uint64_t writes = Get( page_writes[page] );
+
+        if ( writes == 0 )
+            continue;
+
+        snprintf(buffer, sizeof(buffer), "emulator_page_writes_total{page=\"%02X\"} %llu\n",
+                 static_cast<unsigned int>(page), static_cast<unsigned long long>(writes));
+        output << buffer;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SESSIONSTATISTICS_HPP
+#define SESSIONSTATISTICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+
+/** Counters describing a long-running session, readable from another thread.
+ *
+ *  Only the thread running the CPU ever changes these, so they are updated
+ *  with a relaxed load and store rather than a read-modify-write.  That is
+ *  as cheap as a plain increment, never blocks, and lets an exporter on
+ *  another thread read consistent (if slightly stale) values at any time.
+ */
+class SessionStatistics
+{
+public:
+    using counterType = std::atomic<uint64_t>;
+
+    SessionStatistics();
+
+    /// Adds one to a counter.  Only to be called from the thread running the CPU.
+    static void Increment(counterType &counter)
+    {
+        counter.store( counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed );
+    }
+
+    static void Set(counterType &counter, uint64_t value) { counter.store( value, std::memory_order_relaxed ); }
+    static uint64_t Get(const counterType &counter) { return counter.load( std::memory_order_relaxed ); }
+
+    void countWrite(uint16_t address) { Increment( page_writes[address >> 8] ); }
+
+    counterType cycles;
+    counterType instructions;
+    counterType irqs;
+    counterType nmis;
+    counterType breakpoints_hit;
+    counterType watchpoints_hit;
+    std::array<counterType, 256> page_writes; ///< Writes by the CPU, per page
+
+    /** Writes the counters in the Prometheus text exposition format.
+     *
+     *  Pages that have never been written are left out.
+     *
+     *  @param output The stream to write to
+     */
+    void exportTo(std::ostream &output) const;
+};
+
+#endif // SESSIONSTATISTICS_HPP
@@ -0,0 +1,85 @@
+#include "statehash.hpp"
+#include <cstring>
+
+
+namespace
+{
+
+constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t RotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Load64(const uint8_t *data)
+{
+    uint64_t value;
+
+    memcpy( &value, data, sizeof(value) );
+    return value;
+}
+
+inline uint64_t Round(uint64_t lane, uint64_t input)
+{
+    return RotateLeft( lane + input * Prime2, 31 ) * Prime1;
+}
+
+inline uint64_t MergeRound(uint64_t hash, uint64_t lane)
+{
+    return (hash ^ Round( 0, lane )) * Prime1 + Prime4;
+}
+
+inline uint64_t Avalanche(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    return hash ^ (hash >> 32);
+}
+
+}
+
+uint64_t HashBytes(const uint8_t *data, size_t size, uint64_t seed)
+{
+    const uint8_t *const end = data + size;
+    uint64_t hash;
+
+    if ( size >= 32 )
+    {
+        uint64_t lanes[4] = { seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1 };
+
+        for ( ; data + 32 <= end; data += 32)
+        {
+            lanes[0] = Round( lanes[0], Load64( data ) );
+            lanes[1] = Round( lanes[1], Load64( data + 8 ) );
+            lanes[2] = Round( lanes[2], Load64( data + 16 ) );
+            lanes[3] = Round( lanes[3], Load64( data + 24 ) );
+        }
+
+        hash = RotateLeft( lanes[0], 1 ) + RotateLeft( lanes[1], 7 ) + RotateLeft( lanes[2], 12 ) + RotateLeft( lanes[3], 18 );
+        for (uint64_t iCurrentLane : lanes)
+            hash = MergeRound( hash, iCurrentLane );
+    }
+    else
+        hash = seed + Prime5;
+
+    hash += size;
+
+    for ( ; data + 8 <= end; data += 8)
+        hash = RotateLeft( hash ^ Round( 0, Load64( data ) ), 27 ) * Prime1 + Prime4;
+    for ( ; data < end; ++data)
+        hash = RotateLeft( hash ^ (*data * Prime5), 11 ) * Prime1;
+
+    return Avalanche( hash );
+}
+
+uint64_t HashCombine(uint64_t hash, uint64_t value)
+{
+    return Avalanche( RotateLeft( hash ^ Round( 0, value ), 27 ) * Prime1 + Prime4 );
+}
@@ -0,0 +1,28 @@
+#ifndef STATEHASH_HPP
+#define STATEHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+/** Fast, non-cryptographic hashing for telling whether two machine states
+ *  are the same.
+ *
+ *  @c HashBytes() works through 32 bytes at a time in four independent
+ *  lanes (the rounds of xxHash64), so the whole 64KB of memory hashes in a few
+ *  microseconds.  Memory is read in the host's byte order, so hashes are only
+ *  comparable between hosts of the same endianness.
+ */
+
+/** Hashes a block of bytes.
+ *
+ *  @param data The bytes to hash
+ *  @param size How many there are
+ *  @param seed Start from a different value, to chain hashes together
+ */
+uint64_t HashBytes(const uint8_t *data, size_t size, uint64_t seed = 0);
+
+/** Mixes a value into a hash. */
+uint64_t HashCombine(uint64_t hash, uint64_t value);
+
+#endif // STATEHASH_HPP
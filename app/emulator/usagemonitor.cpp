@@ -0,0 +1,38 @@
+#include "usagemonitor.hpp"
+#include <cstdio>
+
+
+void UsageMonitor::reset(uint8_t stack_pointer)
+{
+    _lowest_stack_pointer = stack_pointer;
+    _lowest_stack_pointer_address = 0;
+    _overflows = 0;
+    _underflows = 0;
+    _zero_page.reset();
+}
+
+void UsageMonitor::report(std::ostream &output) const
+{
+    char buffer[96];
+
+    snprintf(buffer, sizeof(buffer), "Stack: lowest SP $%02X (%d bytes) by $%04X, %u overflows, %u underflows\n",
+             static_cast<unsigned int>(_lowest_stack_pointer),
+             stackDepth(),
+             static_cast<unsigned int>(_lowest_stack_pointer_address),
+             static_cast<unsigned int>(_overflows),
+             static_cast<unsigned int>(_underflows));
+    output << buffer;
+
+    snprintf(buffer, sizeof(buffer), "Zero page: %u of 256 bytes used\n", static_cast<unsigned int>(zeroPageCount()));
+    output << buffer;
+
+    output << "     0123456789ABCDEF\n";
+    for (int row = 0; row < 16; ++row)
+    {
+        snprintf(buffer, sizeof(buffer), "  %X0 ", row);
+        output << buffer;
+        for (int column = 0; column < 16; ++column)
+            output << (_zero_page.test( (row << 4) | column ) ? '#' : '.');
+        output << '\n';
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef USAGEMONITOR_HPP
+#define USAGEMONITOR_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+
+/** Keeps high-water marks of how much of the stack and zero page is used.
+ *
+ *  The CPU tells this about every change of the stack pointer and every
+ *  zero page access, so the worst-case stack depth of a program can be
+ *  found without tracing it.  It is always on: an instruction that leaves
+ *  the stack pointer alone costs one compare, and a zero page access one
+ *  compare and a bit set.
+ */
+class UsageMonitor
+{
+public:
+    using addressType = uint16_t;
+
+    /** Notes a change of the stack pointer by one instruction or interrupt.
+     *
+     *  @param before              The stack pointer before
+     *  @param after               The stack pointer after
+     *  @param instruction_address The address of the instruction responsible
+     *  @param transfer            true for TXS, which sets the stack pointer rather than pushing or pulling
+     */
+    void noteStackPointer(uint8_t before, uint8_t after, addressType instruction_address, bool transfer)
+    {
+        if ( after == before )
+            return;
+
+        if ( after < _lowest_stack_pointer )
+        {
+            _lowest_stack_pointer = after;
+            _lowest_stack_pointer_address = instruction_address;
+        }
+
+        if ( transfer )
+            return;
+
+        // Pushes and pulls only ever move it by a few bytes, so the sign of
+        // the 8-bit difference gives the direction even across a wrap
+        const int8_t change = static_cast<int8_t>( after - before );
+
+        if ( (change < 0) && (after > before) )
+            ++_overflows;
+        else if ( (change > 0) && (after < before) )
+            ++_underflows;
+    }
+
+    void touchZeroPage(addressType address)
+    {
+        if ( address < 0x0100 )
+            _zero_page.set( address );
+    }
+
+    /// The lowest the stack pointer has been, which is the deepest the stack has grown.
+    uint8_t lowestStackPointer() const { return _lowest_stack_pointer; }
+
+    /// The address of the instruction that took the stack pointer to its lowest.
+    addressType lowestStackPointerAddress() const { return _lowest_stack_pointer_address; }
+
+    /// The number of bytes of stack used at the deepest point.
+    int stackDepth() const { return 0xFF - _lowest_stack_pointer; }
+
+    /// The number of times a push went below $0100 and wrapped around to $01FF.
+    uint32_t stackOverflows() const { return _overflows; }
+
+    /// The number of times a pull went above $01FF and wrapped around to $0100.
+    uint32_t stackUnderflows() const { return _underflows; }
+
+    const std::bitset<256> &zeroPage() const { return _zero_page; }
+    bool   zeroPageTouched(addressType address) const { return _zero_page.test( address & 0xFF ); }
+    size_t zeroPageCount() const { return _zero_page.count(); }
+
+    /** Starts over, from a stack pointer of @p stack_pointer.
+     */
+    void reset(uint8_t stack_pointer = 0xFF);
+
+    /** Writes the high-water marks as text, with a map of the zero page bytes used.
+     *
+     *  @param output The stream to write to
+     */
+    void report(std::ostream &output) const;
+
+protected:
+    uint8_t          _lowest_stack_pointer = 0xFF;
+    addressType      _lowest_stack_pointer_address = 0;
+    uint32_t         _overflows = 0;
+    uint32_t         _underflows = 0;
+    std::bitset<256> _zero_page;
+};
+
+#endif // USAGEMONITOR_HPP
@@ -0,0 +1,34 @@
+#include "writeprovenance.hpp"
+#include <cstdio>
+
+
+WriteProvenance::WriteProvenance()
+{
+    clear();
+}
+
+void WriteProvenance::clear()
+{
+    for (auto &iCurrentWriter : _writers)
+        iCurrentWriter.store( 0, std::memory_order_relaxed );
+    for (auto &iCurrentCycle : _cycles)
+        iCurrentCycle.store( NeverWritten, std::memory_order_relaxed );
+}
+
+void WriteProvenance::exportTo(std::ostream &output) const
+{
+    char buffer[64];
+
+    output << "address,writer,cycle\n";
+    for (size_t address = 0; address < _cycles.size(); ++address)
+    {
+        if ( !written( static_cast<addressType>(address) ) )
+            snprintf(buffer, sizeof(buffer), "$%04X,,\n", static_cast<unsigned int>(address));
+        else
+            snprintf(buffer, sizeof(buffer), "$%04X,$%04X,%llu\n",
+                     static_cast<unsigned int>(address),
+                     static_cast<unsigned int>(writer( static_cast<addressType>(address) )),
+                     static_cast<unsigned long long>(cycle( static_cast<addressType>(address) )));
+        output << buffer;
+    }
+}
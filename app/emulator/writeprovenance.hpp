@@ -0,0 +1,61 @@
+#ifndef WRITEPROVENANCE_HPP
+#define WRITEPROVENANCE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+
+/** Shadow memory recording who last wrote each byte of the address space.
+ *
+ *  For every address this keeps the address of the instruction that last
+ *  wrote to it and the clock tick it started on, answering "who wrote this
+ *  byte?".  Recording a write is a store into each of two dense arrays.
+ *  The stores are relaxed atomics, which cost no more than plain ones, so
+ *  the memory page can show them while the emulation thread is recording.
+ */
+class WriteProvenance
+{
+public:
+    using addressType = uint16_t;
+    using cycleType   = uint64_t;
+
+    /// The cycle of an address that hasn't been written since the last @c clear().
+    static constexpr cycleType NeverWritten = UINT64_MAX;
+
+    WriteProvenance();
+
+    void record(addressType address, addressType writer, cycleType cycle)
+    {
+        _writers[address].store( writer, std::memory_order_relaxed );
+        _cycles[address].store( cycle, std::memory_order_relaxed );
+    }
+
+    bool written(addressType address) const { return cycle(address) != NeverWritten; }
+
+    /// The address of the instruction that last wrote to @p address.
+    addressType writer(addressType address) const { return _writers[address].load( std::memory_order_relaxed ); }
+
+    /// The clock tick the last write to @p address was made on, or @c NeverWritten.
+    cycleType cycle(addressType address) const { return _cycles[address].load( std::memory_order_relaxed ); }
+
+    /** Forgets every write recorded so far.
+     */
+    void clear();
+
+    /** Writes the whole address space as CSV.
+     *
+     *  The columns are "address,writer,cycle".  The writer and cycle are
+     *  left empty for addresses that were never written.
+     *
+     *  @param output The stream to write to
+     */
+    void exportTo(std::ostream &output) const;
+
+protected:
+    std::array<std::atomic<addressType>, 64 * 1024> _writers;
+    std::array<std::atomic<cycleType>, 64 * 1024>   _cycles;
+};
+
+#endif // WRITEPROVENANCE_HPP
@@ -0,0 +1,205 @@
+#include "headlessrunner.hpp"
+#include "statisticsexporter.hpp"
+#include "hostcounters.hpp"
+#include "emulator/lockstepchecker.hpp"
+#include "utilities/Profiling.hpp"
+#include <QCommandLineParser>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+
+bool HeadlessRunner::Requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if ( std::strcmp( argv[i], "--headless" ) == 0 )
+            return true;
+    }
+    return false;
+}
+
+int HeadlessRunner::exec(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    QCommandLineOption headless_option( "headless", "Run without the terminal UI." );
+    QCommandLineOption cycles_option( "cycles", "Stop after <count> clock cycles.", "count", "1000000" );
+    QCommandLineOption profile_option( "profile", "Write the instruction mix and penalty report to <file>.", "file" );
+    QCommandLineOption stats_port_option( "stats-port", "Publish statistics on localhost <port> while running.", "port" );
+    QCommandLineOption host_counters_option( "host-counters", "Print the host's hardware counters for the run." );
+    QCommandLineOption lockstep_option( "lockstep", "Check another backend against the reference every <interval> instructions.", "interval" );
+    QCommandLineOption lockstep_backend_option( "lockstep-backend", "The backend to check with --lockstep.", "name", "reference" );
+
+    parser.setApplicationDescription( "Runs a 6502 program without the terminal UI." );
+    parser.addHelpOption();
+    parser.addOption( headless_option );
+    parser.addOption( cycles_option );
+    parser.addOption( profile_option );
+    parser.addOption( stats_port_option );
+    parser.addOption( host_counters_option );
+    parser.addOption( lockstep_option );
+    parser.addOption( lockstep_backend_option );
+    parser.addPositionalArgument( "program", "The program to load and run." );
+    parser.process( arguments );
+
+    bool valid_cycles = false;
+    uint32_t remaining_cycles = parser.value( cycles_option ).toUInt( &valid_cycles );
+
+    if ( !valid_cycles || (parser.positionalArguments().size() != 1) )
+    {
+        std::cerr << parser.helpText().toStdString();
+        return UsageError;
+    }
+
+    const QString program = parser.positionalArguments().first();
+
+    if ( !_computer.loadProgram( program ) )
+    {
+        std::cerr << "Unable to load " << program.toStdString() << "\n";
+        return UsageError;
+    }
+
+    if ( parser.isSet( lockstep_option ) )
+    {
+        bool valid_interval = false;
+        const uint32_t interval = parser.value( lockstep_option ).toUInt( &valid_interval );
+
+        if ( !valid_interval || (interval == 0) )
+        {
+            std::cerr << parser.helpText().toStdString();
+            return UsageError;
+        }
+        return runLockstep( interval, parser.value( lockstep_backend_option ), remaining_cycles );
+    }
+
+    // Unlike a breakpoint on the IRQ handler, this keeps the run on Computer's
+    // plain loop, so --host-counters measures the interpreter and nothing else
+    _computer.setStopOnBrk( true );
+    _computer.setProfileEnabled( parser.isSet( profile_option ) );
+
+    std::unique_ptr<StatisticsExporter> statistics_exporter;
+
+    if ( parser.isSet( stats_port_option ) )
+    {
+        bool valid_port = false;
+        const quint16 port = parser.value( stats_port_option ).toUShort( &valid_port );
+
+        _computer.setStatisticsEnabled( true );
+        statistics_exporter = std::make_unique<StatisticsExporter>( _computer.statistics(), port );
+        if ( !valid_port || !statistics_exporter->startListening() )
+        {
+            std::cerr << "Unable to listen on port " << parser.value( stats_port_option ).toStdString() << "\n";
+            return UsageError;
+        }
+    }
+
+    std::unique_ptr<HostCounters> host_counters;
+
+    if ( parser.isSet( host_counters_option ) )
+        host_counters = std::make_unique<HostCounters>();
+
+    const uint64_t start_ticks = _computer.cpu()->clockTicks();
+    const uint64_t start_instructions = _computer.cpu()->instructionCount();
+
+    if ( host_counters )
+        host_counters->start();
+
+    const int exit_code = runFor( remaining_cycles );
+
+    if ( host_counters )
+    {
+        host_counters->stop();
+        host_counters->report( std::cerr,
+                               _computer.cpu()->instructionCount() - start_instructions,
+                               _computer.cpu()->clockTicks() - start_ticks );
+    }
+
+    if ( parser.isSet( profile_option ) && !_computer.exportProfile( parser.value( profile_option ) ) )
+        std::cerr << "Unable to write " << parser.value( profile_option ).toStdString() << "\n";
+    PROFILE_DUMP("trace.json");
+    return exit_code;
+}
+
+int HeadlessRunner::runFor(uint32_t remaining_cycles)
+{
+    while ( remaining_cycles > 0 )
+    {
+        const uint64_t start_ticks = _computer.cpu()->clockTicks();
+        const Computer::StopReason reason = _computer.run( std::min( remaining_cycles, BatchCycles ) );
+
+        remaining_cycles -= static_cast<uint32_t>( _computer.cpu()->clockTicks() - start_ticks );
+
+        if ( reason == Computer::StopReason::Brk )
+        {
+            char buffer[64];
+
+            snprintf(buffer, sizeof(buffer), "BRK at $%04X after %llu cycles\n",
+                     static_cast<unsigned int>(_computer.cpu()->flightRecorder().last().program_counter),
+                     static_cast<unsigned long long>(_computer.cpu()->clockTicks()));
+            std::cerr << buffer;
+            printRegisters( std::cerr );
+            _computer.cpu()->usageMonitor().report( std::cerr );
+            std::cerr << "\nLast instructions executed:\n";
+            _computer.dumpFlightRecorder( std::cerr );
+            return AbnormalStop;
+        }
+    }
+
+    printRegisters( std::cout );
+    _computer.cpu()->usageMonitor().report( std::cout );
+    return Success;
+}
+
+int HeadlessRunner::runLockstep(uint32_t interval, const QString &backend, uint32_t cycles)
+{
+    std::unique_ptr<CpuBackend> candidate = CpuBackend::Create( backend.toStdString() );
+
+    if ( !candidate )
+    {
+        std::cerr << "There is no backend called " << backend.toStdString() << "\n";
+        return UsageError;
+    }
+
+    // Both start where the loaded program would, just after the reset
+    _computer.stepInstruction();
+
+    CpuState state;
+
+    state.registers = _computer.cpu()->registers();
+    state.memory = _computer.ram()->memory();
+    state.cycles = _computer.cpu()->clockTicks();
+    state.write_hash = CpuBackend::InitialWriteHash;
+
+    LockstepChecker checker( CpuBackend::Create( "reference" ), std::move(candidate), interval );
+
+    checker.start( state );
+    if ( checker.run( cycles ) )
+    {
+        checker.report( std::cout );
+        return Success;
+    }
+
+    checker.report( std::cerr );
+    return AbnormalStop;
+}
+
+void HeadlessRunner::printRegisters(std::ostream &output) const
+{
+    const olc6502 &cpu = *_computer.cpu();
+    char buffer[80];
+
+    snprintf(buffer, sizeof(buffer), "PC:%04X A:%02X X:%02X Y:%02X SP:%02X P:%02X CYC:%llu\n",
+             static_cast<unsigned int>(cpu.pc()),
+             static_cast<unsigned int>(cpu.a()),
+             static_cast<unsigned int>(cpu.x()),
+             static_cast<unsigned int>(cpu.y()),
+             static_cast<unsigned int>(cpu.stackPointer()),
+             static_cast<unsigned int>(cpu.status()),
+             static_cast<unsigned long long>(cpu.clockTicks()));
+    output << buffer;
+
+    snprintf(buffer, sizeof(buffer), "State hash: %016llX\n", static_cast<unsigned long long>(_computer.stateHash()));
+    output << buffer;
+}
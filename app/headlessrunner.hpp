@@ -0,0 +1,71 @@
+#ifndef HEADLESSRUNNER_HPP
+#define HEADLESSRUNNER_HPP
+
+#include <QStringList>
+#include "emulator/computer.hpp"
+#include <iosfwd>
+
+
+/** Runs a program without the terminal UI.
+ *
+ *  Started with "--headless", for scripts and automated testing:
+ *
+ *      cli-6502-playground --headless [--cycles count] [--profile file] [--stats-port port] [--host-counters]
+ *                          [--lockstep interval [--lockstep-backend name]] program
+ *
+ *  The program runs for the given number of clock cycles, then the
+ *  registers, a hash of the whole machine state and the stack and zero page
+ *  high-water marks are printed.  Executing a BRK is treated as an abnormal
+ *  stop, since it is what a program that runs off into zeroed memory or data
+ *  usually ends up doing.  It is caught by a flag the CPU sets, which costs
+ *  next to nothing, rather than a breakpoint, which would take every run off
+ *  the emulator's fastest loop.  On an abnormal stop the flight recorder is
+ *  printed as well, so the path that led there can be seen.
+ *
+ *  With "--profile", the instruction mix and penalty report is written to
+ *  the file however the run ends.  With "--stats-port", the session
+ *  statistics can be scraped while it runs.  With "--host-counters", the
+ *  host processor's cycles, instructions, branch misses and L1D misses
+ *  during the run are printed per emulated instruction.  With "--lockstep",
+ *  the program is instead run on the reference core and another backend side
+ *  by side, stopping with the differences at the first instruction where
+ *  they disagree.
+ */
+class HeadlessRunner
+{
+public:
+    enum ExitCode
+    {
+        Success      = 0, ///< Ran for all of the cycles
+        AbnormalStop = 1, ///< Stopped early, such as on a BRK
+        UsageError   = 2  ///< Bad arguments or the program could not be loaded
+    };
+
+    /** Tells whether the command line asks for the headless runner.
+     *
+     *  This has to be decided before the application object is made, since
+     *  the interactive one takes over the terminal.
+     */
+    static bool Requested(int argc, char *argv[]);
+
+    /** Parses the command line, then loads and runs the program.
+     *
+     *  @param arguments The command line arguments, including the program name
+     *
+     *  @return The process exit code
+     *
+     *  @see ExitCode
+     */
+    int exec(const QStringList &arguments);
+
+protected:
+    static constexpr uint32_t BatchCycles = 10000;
+
+    Computer _computer;
+
+    int  runFor(uint32_t remaining_cycles);
+    int  runLockstep(uint32_t interval, const QString &backend, uint32_t cycles);
+    void printRegisters(std::ostream &output) const;
+};
+
+#endif // HEADLESSRUNNER_HPP
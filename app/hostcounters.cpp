@@ -0,0 +1,193 @@
+#include "hostcounters.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef __linux__
+
+namespace
+{
+
+struct CounterEvent
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr CounterEvent CounterEvents[HostCounters::CounterCount] =
+{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }
+};
+
+// The layout read() returns for PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+struct CounterReading
+{
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+};
+
+int OpenCounter(const CounterEvent &event)
+{
+    perf_event_attr attributes;
+
+    memset( &attributes, 0, sizeof(attributes) );
+    attributes.size = sizeof(attributes);
+    attributes.type = event.type;
+    attributes.config = event.config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>( syscall( SYS_perf_event_open, &attributes, 0, -1, -1, 0 ) );
+}
+
+}
+
+HostCounters::HostCounters()
+{
+    for (int counter = 0; counter < CounterCount; ++counter)
+    {
+        _descriptors[counter] = OpenCounter( CounterEvents[counter] );
+        if ( (_descriptors[counter] < 0) && _error.empty() )
+            _error = std::string("perf_event_open: ") + strerror( errno );
+    }
+}
+
+HostCounters::~HostCounters()
+{
+    for (int descriptor : _descriptors)
+        if ( descriptor >= 0 )
+            close( descriptor );
+}
+
+void HostCounters::start()
+{
+    _values.fill( 0 );
+    for (int descriptor : _descriptors)
+    {
+        if ( descriptor < 0 )
+            continue;
+
+        ioctl( descriptor, PERF_EVENT_IOC_RESET, 0 );
+        ioctl( descriptor, PERF_EVENT_IOC_ENABLE, 0 );
+    }
+}
+
+void HostCounters::stop()
+{
+    for (int counter = 0; counter < CounterCount; ++counter)
+    {
+        if ( _descriptors[counter] < 0 )
+            continue;
+
+        CounterReading reading;
+
+        ioctl( _descriptors[counter], PERF_EVENT_IOC_DISABLE, 0 );
+        if ( read( _descriptors[counter], &reading, sizeof(reading) ) != sizeof(reading) )
+            _values[counter] = 0;
+        else if ( (reading.time_running != 0) && (reading.time_running < reading.time_enabled) )
+            _values[counter] = static_cast<uint64_t>( static_cast<double>(reading.value) * reading.time_enabled / reading.time_running );
+        else
+            _values[counter] = reading.value;
+    }
+}
+
+#else
+
+HostCounters::HostCounters()
+    :
+    _error( "hardware counters are only supported on Linux" )
+{
+    _descriptors.fill( -1 );
+}
+
+HostCounters::~HostCounters() = default;
+
+void HostCounters::start()
+{
+}
+
+void HostCounters::stop()
+{
+}
+
+#endif // __linux__
+
+bool HostCounters::anyAvailable() const
+{
+    for (int descriptor : _descriptors)
+        if ( descriptor >= 0 )
+            return true;
+    return false;
+}
+
+void HostCounters::report(std::ostream &output, uint64_t instructions, uint64_t cycles) const
+{
+    if ( !anyAvailable() )
+    {
+        output << "Host counters: not available (" << _error << ")\n";
+        return;
+    }
+
+    char buffer[96];
+
+    output << "Host counters:       total  per instr   per cycle\n";
+    for (int counter = 0; counter < CounterCount; ++counter)
+    {
+        if ( !available( static_cast<Counter>(counter) ) )
+        {
+            snprintf(buffer, sizeof(buffer), "  %-13s not available\n", CounterName( static_cast<Counter>(counter) ));
+            output << buffer;
+            continue;
+        }
+
+        const double total = static_cast<double>( _values[counter] );
+
+        snprintf(buffer, sizeof(buffer), "  %-13s %12llu %10.3f %11.3f\n",
+                 CounterName( static_cast<Counter>(counter) ),
+                 static_cast<unsigned long long>(_values[counter]),
+                 (instructions != 0) ? total / instructions : 0.0,
+                 (cycles != 0) ? total / cycles : 0.0);
+        output << buffer;
+    }
+
+    if ( available(Cycles) && available(Instructions) && (_values[Cycles] != 0) )
+    {
+        snprintf(buffer, sizeof(buffer), "  Host IPC: %.2f\n", static_cast<double>(_values[Instructions]) / _values[Cycles]);
+        output << buffer;
+    }
+}
+
+const char *HostCounters::CounterName(Counter counter)
+{
+    switch (counter)
+    {
+    case Cycles:
+        return "Cycles";
+    case Instructions:
+        return "Instructions";
+    case BranchMisses:
+        return "Branch misses";
+    case L1DMisses:
+        return "L1D misses";
+    default:
+        break;
+    }
+    return "";
+}
@@ -0,0 +1,73 @@
+#ifndef HOSTCOUNTERS_HPP
+#define HOSTCOUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+
+/** Counts what the host processor does while the emulator runs.
+ *
+ *  Uses the Linux perf_event_open() hardware counters for the calling thread
+ *  (user space only, so it works with the default perf_event_paranoid
+ *  setting).  Each counter is opened on its own, so one the processor or the
+ *  kernel doesn't provide (common in virtual machines) is just left out of the
+ *  report.  On other systems nothing is available and the report says so.
+ *
+ *  The counts are divided by the emulated instructions and cycles of the run,
+ *  so interpreter changes can be compared on the same program.  A 6502 cycle
+ *  is one bus access, so the L1D misses per cycle are the misses per emulated
+ *  memory access.
+ */
+class HostCounters
+{
+public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        BranchMisses,
+        L1DMisses,
+        CounterCount
+    };
+
+    HostCounters();
+   ~HostCounters();
+
+    HostCounters(const HostCounters &) = delete;
+    HostCounters &operator =(const HostCounters &) = delete;
+
+    bool available(Counter counter) const { return _descriptors[counter] >= 0; }
+    bool anyAvailable() const;
+
+    /// Resets the counters and starts counting
+    void start();
+
+    /// Stops counting and reads the counters
+    void stop();
+
+    /** The count of the last run between @c start() and @c stop().
+     *
+     *  If the kernel had to share the hardware counters with others, the
+     *  count is scaled up to the whole run.
+     */
+    uint64_t value(Counter counter) const { return _values[counter]; }
+
+    /** Writes the counts per emulated instruction and cycle.
+     *
+     *  @param output       Where to write the report
+     *  @param instructions The emulated instructions executed during the run
+     *  @param cycles       The emulated clock cycles of the run
+     */
+    void report(std::ostream &output, uint64_t instructions, uint64_t cycles) const;
+
+    static const char *CounterName(Counter counter);
+
+protected:
+    std::array<int, CounterCount>      _descriptors;
+    std::array<uint64_t, CounterCount> _values{};
+    std::string                        _error; ///< Why the first counter that failed couldn't be opened
+};
+
+#endif // HOSTCOUNTERS_HPP
@@ -1,6 +1,7 @@
 #include "io/io.hpp"
 #include "io/SRecord/QSRecordStream.hpp"
 #include "io/SimpleHex/QSimpleHexStream.hpp"
+#include "utilities/Profiling.hpp"
 #include <iterator>
 #include <algorithm>
 #include <optional>
@@ -62,6 +63,19 @@ static OptionalProgram ReadSimpleHexFrom(QIODevice *device)
     return Program{ std::move(blocks.value()) };
 }
 
+static OptionalProgram ReadBinaryFrom(QIODevice *device)
+{
+    // A raw image of memory starting at $0000, such as the 6502 functional
+    // test.  There is no execution address, so the reset vector is whatever
+    // the image holds.
+    QByteArray temp_data = device->read( 64 * 1024 + 1 );
+
+    if ( temp_data.isEmpty() || (temp_data.size() > 64 * 1024) )
+        return std::nullopt;
+
+    return Program{ MemoryBlocks{ MemoryBlock{ 0, Bytes{ temp_data.begin(), temp_data.end() } } } };
+}
+
 namespace SRecord_IO
 {
 
@@ -150,6 +164,7 @@ OptionalProgram ReadS19RecordsFrom(QIODevice *device)
 }
 
 FileTypeTable_t FileTypeTable{
+    { QStringLiteral(".bin"),  &ReadBinaryFrom },
     { QStringLiteral(".prg"),  &ReadPRGFrom },
     { QStringLiteral(".shex"), &ReadSimpleHexFrom },
     { QStringLiteral(".srec"), &SRecord_IO::ReadSRecordsFrom },
@@ -160,6 +175,8 @@ FileTypeTable_t FileTypeTable{
 
 OptionalProgram ReadFromFile(QString filename)
 {
+    PROFILE_FUNCTION();
+
     if ( !QFile::exists( filename ) )
         return std::nullopt;
 
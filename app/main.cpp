@@ -1,7 +1,18 @@
 #include "cliplaygroundapplication.h"
+#include "headlessrunner.hpp"
 
 int main(int argc, char *argv[])
 {
+    if ( HeadlessRunner::Requested(argc, argv) )
+    {
+        QCoreApplication app(argc, argv);
+        HeadlessRunner   runner;
+
+        QCoreApplication::setApplicationName("cli-6502-playground");
+        QCoreApplication::setApplicationVersion("1.0.0");
+        return runner.exec( app.arguments() );
+    }
+
     CLIPlaygroundApplication app(argc, argv);
 
     app.setup_ui();
@@ -0,0 +1,43 @@
+#include "performancemonitor.hpp"
+
+
+void PerformanceMonitor::frame(uint64_t clock_ticks, uint64_t instructions)
+{
+    using namespace std::chrono;
+
+    if ( !_started )
+    {
+        restart( clock_ticks, instructions );
+        return;
+    }
+
+    ++_frames;
+
+    const clockType::time_point now = clockType::now();
+    const clockType::duration   elapsed = now - _sample_start;
+
+    if ( elapsed < SampleInterval )
+        return;
+
+    const double   seconds = duration<double>( elapsed ).count();
+    const uint64_t executed = instructions - _sample_instructions;
+
+    _rates.cycles_per_second       = (clock_ticks - _sample_clock_ticks) / seconds;
+    _rates.instructions_per_second = executed / seconds;
+    _rates.host_ns_per_instruction = executed ? (duration<double, std::nano>( _run_time ).count() / executed) : 0.0;
+    _rates.render_ms_per_frame     = duration<double, std::milli>( _render_time ).count() / _frames;
+    _rates.frames_per_second       = _frames / seconds;
+
+    restart( clock_ticks, instructions );
+}
+
+void PerformanceMonitor::restart(uint64_t clock_ticks, uint64_t instructions)
+{
+    _sample_start = clockType::now();
+    _sample_clock_ticks = clock_ticks;
+    _sample_instructions = instructions;
+    _run_time = clockType::duration::zero();
+    _render_time = clockType::duration::zero();
+    _frames = 0;
+    _started = true;
+}
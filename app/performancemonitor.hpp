@@ -0,0 +1,61 @@
+#ifndef PERFORMANCEMONITOR_HPP
+#define PERFORMANCEMONITOR_HPP
+
+#include <chrono>
+#include <cstdint>
+
+
+/** Measures how fast the emulator and the UI actually run.
+ *
+ *  The main loop adds the host time it spends running the CPU and rendering,
+ *  and calls @c frame() once per frame with the CPU's counters.  The rates are
+ *  only worked out from those totals every @c SampleInterval, so there is
+ *  nothing to pay per instruction beyond the counters the CPU already keeps.
+ */
+class PerformanceMonitor
+{
+public:
+    using clockType = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds SampleInterval{ 500 };
+
+    struct Rates
+    {
+        double cycles_per_second = 0.0;       ///< Emulated clock cycles per second of wall time
+        double instructions_per_second = 0.0;
+        double host_ns_per_instruction = 0.0; ///< Host time spent running the CPU, per instruction
+        double render_ms_per_frame = 0.0;     ///< Host time spent handling events and rendering, per frame
+        double frames_per_second = 0.0;
+    };
+
+    void addRunTime(clockType::duration elapsed) { _run_time += elapsed; }
+    void addRenderTime(clockType::duration elapsed) { _render_time += elapsed; }
+
+    /** Counts a frame, updating the rates once enough time has gone by.
+     *
+     *  @param clock_ticks  The CPU's clock tick counter
+     *  @param instructions The CPU's count of instructions executed
+     */
+    void frame(uint64_t clock_ticks, uint64_t instructions);
+
+    /** Starts a new sample, forgetting the time since the last frame.
+     *
+     *  Call this when the simulation starts running again, so time spent
+     *  paused doesn't count against the rates.
+     */
+    void restart(uint64_t clock_ticks, uint64_t instructions);
+
+    const Rates &rates() const { return _rates; }
+
+protected:
+    Rates                  _rates;
+    clockType::time_point  _sample_start;
+    uint64_t               _sample_clock_ticks = 0;
+    uint64_t               _sample_instructions = 0;
+    clockType::duration    _run_time{};
+    clockType::duration    _render_time{};
+    int                    _frames = 0;
+    bool                   _started = false;
+};
+
+#endif // PERFORMANCEMONITOR_HPP
@@ -0,0 +1,75 @@
+#include "statisticsexporter.hpp"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <ctime>
+#include <cstdio>
+#include <sstream>
+
+
+StatisticsExporter::StatisticsExporter(const SessionStatistics &statistics, quint16 port, QObject *parent)
+    :
+    QThread(parent),
+    _statistics(statistics),
+    _port(port)
+{
+}
+
+StatisticsExporter::~StatisticsExporter()
+{
+    quit();
+    wait();
+}
+
+bool StatisticsExporter::startListening()
+{
+    start();
+    while ( _state == Starting )
+        QThread::msleep( 1 );
+    return _state == Listening;
+}
+
+void StatisticsExporter::run()
+{
+    // Everything made here belongs to this thread, and is serviced by its event loop
+    QTcpServer server;
+
+    if ( !server.listen( QHostAddress::LocalHost, _port ) )
+    {
+        _state = Failed;
+        return;
+    }
+    _state = Listening;
+
+    QObject::connect(&server, &QTcpServer::newConnection,
+                     [this, &server]()
+                     {
+                         while ( QTcpSocket *socket = server.nextPendingConnection() )
+                         {
+                             QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+
+                             // Answer as soon as anything arrives.  The request itself doesn't matter.
+                             QObject::connect(socket, &QTcpSocket::readyRead,
+                                              [this, socket]()
+                                              {
+                                                  std::ostringstream body;
+                                                  char cpu_time[96];
+
+                                                  _statistics.exportTo( body );
+                                                  snprintf(cpu_time, sizeof(cpu_time), "# TYPE process_cpu_seconds_total counter\nprocess_cpu_seconds_total %.3f\n",
+                                                           static_cast<double>(std::clock()) / CLOCKS_PER_SEC);
+                                                  body << cpu_time;
+
+                                                  const std::string content = body.str();
+                                                  const std::string header = "HTTP/1.0 200 OK\r\n"
+                                                                             "Content-Type: text/plain; version=0.0.4\r\n"
+                                                                             "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n";
+
+                                                  socket->readAll();
+                                                  socket->write( header.data(), header.size() );
+                                                  socket->write( content.data(), content.size() );
+                                                  socket->disconnectFromHost();
+                                              });
+                         }
+                     });
+    exec();
+}
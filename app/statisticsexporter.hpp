@@ -0,0 +1,46 @@
+#ifndef STATISTICSEXPORTER_HPP
+#define STATISTICSEXPORTER_HPP
+
+#include <QThread>
+#include <atomic>
+#include "emulator/sessionstatistics.hpp"
+
+
+/** Publishes the session statistics on a localhost TCP port.
+ *
+ *  The server runs its own event loop on its own thread, so the emulation
+ *  never waits for it, and answers every request with the counters in the
+ *  Prometheus text format, with an HTTP header so it can be scraped:
+ *
+ *      curl http://localhost:<port>/
+ *
+ *  The host CPU time used by the process is added as
+ *  process_cpu_seconds_total.
+ */
+class StatisticsExporter : public QThread
+{
+    Q_OBJECT
+public:
+    /** @param statistics The counters to publish.  They must outlive the exporter.
+     *  @param port       The TCP port to listen on
+     */
+    StatisticsExporter(const SessionStatistics &statistics, quint16 port, QObject *parent = nullptr);
+   ~StatisticsExporter() override;
+
+    /** Starts the server and waits until it is listening, or has failed to.
+     *
+     *  @return true if the port could be listened on
+     */
+    bool startListening();
+
+protected:
+    enum State { Starting, Listening, Failed };
+
+    const SessionStatistics &_statistics;
+    const quint16            _port;
+    std::atomic<int>         _state{ Starting };
+
+    void run() override;
+};
+
+#endif // STATISTICSEXPORTER_HPP
@@ -1,6 +1,7 @@
 #include "directorybrowser.hpp"
 #include <ftxui/dom/elements.hpp>
 #include "list.hpp"
+#include "utilities/Profiling.hpp"
 #include <QDebug>
 #include <memory>
 #include <vector>
@@ -32,6 +33,8 @@ public:
     /* Generates an internal list of files in the directory of the option */
     void synchronizeWithOption()
     {
+        PROFILE_ZONE("DirectoryBrowser::synchronizeWithOption");
+
         auto default_dir_entry_comparator = [](const filesystem::directory_entry &left,
                                                const filesystem::directory_entry &right)
         {
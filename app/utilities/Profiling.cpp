@@ -0,0 +1,133 @@
+#include "Profiling.hpp"
+
+#ifdef ENABLE_PROFILING
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdio>
+
+namespace Profiling
+{
+
+namespace
+{
+
+struct Event
+{
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration   duration;
+};
+
+/* The zones recorded by one thread.
+ *
+ * Only its own thread appends to it, so the lock is never contended except
+ * while a trace is being written.
+ */
+struct ThreadBuffer
+{
+    std::mutex         lock;
+    std::vector<Event> events;
+    int                thread_id = 0;
+};
+
+struct Registry
+{
+    std::mutex                                 lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+// Timestamps in the trace are relative to the start of the program
+const std::chrono::steady_clock::time_point Origin = std::chrono::steady_clock::now();
+
+Registry &TheRegistry()
+{
+    static Registry registry;
+
+    return registry;
+}
+
+ThreadBuffer &ThisThreadsBuffer()
+{
+    // The registry keeps the buffer alive after the thread exits so its zones can still be written
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []()
+    {
+        Registry &registry = TheRegistry();
+        std::lock_guard<std::mutex> guard( registry.lock );
+        auto new_buffer = std::make_shared<ThreadBuffer>();
+
+        new_buffer->thread_id = static_cast<int>( registry.buffers.size() ) + 1;
+        new_buffer->events.reserve( 4096 );
+        registry.buffers.push_back( new_buffer );
+        return new_buffer;
+    }();
+
+    return *buffer;
+}
+
+void WriteJsonString(std::ostream &output, const char *text)
+{
+    output << '"';
+    for ( ; *text; ++text)
+    {
+        if ( (*text == '"') || (*text == '\\') )
+            output << '\\';
+        output << *text;
+    }
+    output << '"';
+}
+
+}
+
+Zone::~Zone()
+{
+    const auto end = std::chrono::steady_clock::now();
+    ThreadBuffer &buffer = ThisThreadsBuffer();
+    std::lock_guard<std::mutex> guard( buffer.lock );
+
+    buffer.events.push_back( Event{ _name, _start, end - _start } );
+}
+
+bool WriteChromeTrace(const std::string &path)
+{
+    using namespace std::chrono;
+
+    std::ofstream output( path );
+
+    if ( !output )
+        return false;
+
+    Registry &registry = TheRegistry();
+    std::lock_guard<std::mutex> registry_guard( registry.lock );
+    bool first = true;
+    char buffer[128];
+
+    output << "{\"traceEvents\":[\n";
+    for (const auto &iCurrentBuffer : registry.buffers)
+    {
+        std::lock_guard<std::mutex> buffer_guard( iCurrentBuffer->lock );
+
+        for (const Event &iCurrentEvent : iCurrentBuffer->events)
+        {
+            if ( !first )
+                output << ",\n";
+            first = false;
+
+            output << "{\"name\":";
+            WriteJsonString( output, iCurrentEvent.name );
+            snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                     duration<double, std::micro>( iCurrentEvent.start - Origin ).count(),
+                     duration<double, std::micro>( iCurrentEvent.duration ).count(),
+                     iCurrentBuffer->thread_id);
+            output << buffer;
+        }
+    }
+    output << "\n]}\n";
+    return static_cast<bool>(output);
+}
+
+}
+
+#endif // ENABLE_PROFILING
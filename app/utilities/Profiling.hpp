@@ -0,0 +1,64 @@
+#ifndef PROFILING_HPP
+#define PROFILING_HPP
+
+/** Scoped timers for attributing host time to parts of the program.
+ *
+ *  Put PROFILE_ZONE("name") or PROFILE_FUNCTION() at the top of a block and
+ *  the time until the end of the block is recorded into a buffer belonging to
+ *  the calling thread.  PROFILE_DUMP("file.json") writes everything recorded so
+ *  far as a Chrome trace, which chrome://tracing or https://ui.perfetto.dev
+ *  show on a timeline.
+ *
+ *  All of this is compiled out unless the project is built with
+ *  "CONFIG += profiling", which defines ENABLE_PROFILING.
+ */
+
+#ifdef ENABLE_PROFILING
+
+#include <chrono>
+#include <string>
+
+namespace Profiling
+{
+
+class Zone
+{
+public:
+    /// @param name Must stay valid until the trace is dumped, a string literal for instance
+    explicit Zone(const char *name) : _name( name ), _start( std::chrono::steady_clock::now() ) {}
+   ~Zone();
+
+    Zone(const Zone &) = delete;
+    Zone &operator =(const Zone &) = delete;
+
+protected:
+    const char                           *_name;
+    std::chrono::steady_clock::time_point _start;
+};
+
+/** Writes every zone recorded by every thread as Chrome trace-event JSON.
+ *
+ *  @param path The name of the file to create
+ *
+ *  @return true if the file was written
+ */
+bool WriteChromeTrace(const std::string &path);
+
+}
+
+#define PROFILE_CONCATENATE_IMPLEMENTATION(left, right) left##right
+#define PROFILE_CONCATENATE(left, right) PROFILE_CONCATENATE_IMPLEMENTATION(left, right)
+
+#define PROFILE_ZONE(name) Profiling::Zone PROFILE_CONCATENATE(profile_zone_, __LINE__)( name )
+#define PROFILE_FUNCTION() PROFILE_ZONE( __func__ )
+#define PROFILE_DUMP(path) Profiling::WriteChromeTrace( path )
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_DUMP(path) ((void)0)
+
+#endif // ENABLE_PROFILING
+
+#endif // PROFILING_HPP
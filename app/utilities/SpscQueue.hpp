@@ -0,0 +1,66 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+
+/** A fixed-size queue between exactly one producer thread and one consumer thread.
+ *
+ *  Neither side ever blocks or takes a lock: each owns one of the two
+ *  indices and only reads the other's, so a push or pop is a couple of
+ *  loads and a store.  Pushing onto a full queue fails rather than waiting.
+ *
+ *  @tparam T        The type of the items.  Must be default constructible.
+ *  @tparam Capacity The most items it can hold.  A power of two so the indices are just masked.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert( (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two" );
+public:
+    /** Adds an item to the back.  Only to be called from the producer thread.
+     *
+     *  @return false if the queue is full
+     */
+    bool push(T item)
+    {
+        const size_t tail = _tail.load( std::memory_order_relaxed );
+
+        if ( tail - _head.load( std::memory_order_acquire ) == Capacity )
+            return false;
+
+        _items[tail & (Capacity - 1)] = std::move(item);
+        _tail.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+    /** Takes the item at the front.  Only to be called from the consumer thread.
+     *
+     *  @return The item, or nothing if the queue is empty
+     */
+    std::optional<T> pop()
+    {
+        const size_t head = _head.load( std::memory_order_relaxed );
+
+        if ( head == _tail.load( std::memory_order_acquire ) )
+            return std::nullopt;
+
+        std::optional<T> item{ std::move( _items[head & (Capacity - 1)] ) };
+
+        _head.store( head + 1, std::memory_order_release );
+        return item;
+    }
+
+    bool empty() const { return _head.load( std::memory_order_acquire ) == _tail.load( std::memory_order_acquire ); }
+
+protected:
+    std::array<T, Capacity> _items;
+    std::atomic<size_t>     _head{ 0 }; ///< Only changed by the consumer
+    std::atomic<size_t>     _tail{ 0 }; ///< Only changed by the producer
+};
+
+#endif // SPSCQUEUE_HPP
@@ -0,0 +1,230 @@
+#include "bench_emulator.hpp"
+#include "benchmark.hpp"
+#include "emulator/computer.hpp"
+#include "emulator/pageview.hpp"
+#include "emulator/rambusdeviceview.hpp"
+#include "ftxui/dom/node.hpp"
+#include "ftxui/screen/screen.hpp"
+#include <memory>
+#include <vector>
+
+namespace EmulatorBenchmarks
+{
+
+static constexpr uint16_t ProgramAddress = 0x0200;
+static constexpr uint16_t SubroutineAddress = 0x0F00;
+
+/* A class of instructions to time, as the bytes of a short sequence of them.
+ *
+ * The sequence is repeated to fill a page and followed by a JMP back to the
+ * start, so the loop overhead is small.
+ */
+struct OpcodeClass
+{
+    const char          *name;
+    std::vector<uint8_t> sequence;
+};
+
+static const std::vector<OpcodeClass> OpcodeClasses =
+{
+    { "Load/store",     { 0xA9, 0x12,          // LDA #$12
+                          0xA5, 0x10,          // LDA $10
+                          0x85, 0x11,          // STA $11
+                          0xAD, 0x00, 0x03,    // LDA $0300
+                          0x8D, 0x01, 0x03,    // STA $0301
+                          0xB1, 0x20 } },      // LDA ($20),Y
+    { "Arithmetic",     { 0x69, 0x01,          // ADC #$01
+                          0xE9, 0x01,          // SBC #$01
+                          0x65, 0x10,          // ADC $10
+                          0xC9, 0x05,          // CMP #$05
+                          0xE6, 0x10,          // INC $10
+                          0xE8,                // INX
+                          0x88 } },            // DEY
+    { "Logic/shift",    { 0x29, 0x0F,          // AND #$0F
+                          0x09, 0xF0,          // ORA #$F0
+                          0x49, 0xFF,          // EOR #$FF
+                          0x0A,                // ASL A
+                          0x4A,                // LSR A
+                          0x2A,                // ROL A
+                          0x6A,                // ROR A
+                          0x24, 0x10 } },      // BIT $10
+    { "Branch",         { 0x18,                // CLC
+                          0x90, 0x00,          // BCC *+2 (taken)
+                          0xB0, 0x00 } },      // BCS *+2 (not taken)
+    { "Stack",          { 0x48,                // PHA
+                          0x08,                // PHP
+                          0x28,                // PLP
+                          0x68 } },            // PLA
+    { "Transfer/flags", { 0xAA,                // TAX
+                          0x8A,                // TXA
+                          0xA8,                // TAY
+                          0x98,                // TYA
+                          0x38,                // SEC
+                          0x18,                // CLC
+                          0xEA } },            // NOP
+    { "Jump/subroutine", { 0x20, SubroutineAddress & 0xFF, SubroutineAddress >> 8 } } // JSR to an RTS
+};
+
+static void Write(Computer &computer, uint16_t address, const std::vector<uint8_t> &bytes)
+{
+    computer.writeBlock( address, bytes.data(), bytes.size() );
+}
+
+/* Loads a class's loop at ProgramAddress and resets the CPU into it */
+static void LoadLoop(Computer &computer, const std::vector<uint8_t> &sequence)
+{
+    std::vector<uint8_t> program;
+
+    while ( program.size() + sequence.size() <= 250 )
+        program.insert( program.end(), sequence.begin(), sequence.end() );
+    program.insert( program.end(), { 0x4C, ProgramAddress & 0xFF, ProgramAddress >> 8 } ); // JMP ProgramAddress
+
+    Write( computer, ProgramAddress, program );
+    Write( computer, SubroutineAddress, { 0x60 } ); // RTS
+    Write( computer, 0x0020, { 0x00, 0x03 } );      // ($20) points at $0300
+    Write( computer, olc6502::ResetJumpStartAddress, { ProgramAddress & 0xFF, ProgramAddress >> 8 } );
+
+    computer.cpu()->reset();
+    computer.stepInstruction();
+}
+
+static void Clock(BenchmarkRunner &runner)
+{
+    static constexpr uint64_t ClocksPerIteration = 1000;
+
+    Computer computer;
+
+    LoadLoop( computer, OpcodeClasses.front().sequence );
+    runner.run( "InstructionExecutor::clock", ClocksPerIteration, 0, [&computer]()
+    {
+        for (uint64_t i = 0; i < ClocksPerIteration; ++i)
+            computer.cpu()->clock();
+    });
+}
+
+static void RunBatch(BenchmarkRunner &runner)
+{
+    static constexpr uint32_t BatchCycles = 10000;
+
+    Computer computer;
+
+    LoadLoop( computer, OpcodeClasses.front().sequence );
+    runner.run( "Computer::run (per cycle)", BatchCycles, 0, [&computer]()
+    {
+        computer.run( BatchCycles );
+    });
+}
+
+static void StepInstruction(BenchmarkRunner &runner)
+{
+    static constexpr int InstructionsPerIteration = 1000;
+
+    for (const OpcodeClass &iCurrentClass : OpcodeClasses)
+    {
+        Computer computer;
+
+        LoadLoop( computer, iCurrentClass.sequence );
+        runner.run( std::string("Step instruction: ") + iCurrentClass.name, InstructionsPerIteration, 0, [&computer]()
+        {
+            computer.stepInstruction( InstructionsPerIteration );
+        });
+    }
+}
+
+/* The zero page and stack heavy classes, with pages $00-$01 read and written
+ * through the bus and then directly
+ */
+static void DirectPages(BenchmarkRunner &runner)
+{
+    static constexpr uint32_t BatchCycles = 10000;
+
+    for (const OpcodeClass &iCurrentClass : OpcodeClasses)
+    {
+        if ( std::string(iCurrentClass.name) != "Load/store" && std::string(iCurrentClass.name) != "Stack" )
+            continue;
+
+        for (bool direct : { false, true })
+        {
+            Computer computer;
+
+            computer.setDirectPagesEnabled( direct );
+            LoadLoop( computer, iCurrentClass.sequence );
+            runner.run( std::string("Computer::run ") + iCurrentClass.name + ((direct) ? " (direct pages)" : " (through the bus)"),
+                        BatchCycles, 0, [&computer]()
+            {
+                computer.run( BatchCycles );
+            });
+        }
+    }
+}
+
+static void Disassemble(BenchmarkRunner &runner)
+{
+    Computer computer;
+    uint32_t seed = 12345;
+
+    // Random bytes give a realistic mix of instructions and illegal opcodes
+    for (uint32_t address = 0; address <= 0xFFFF; ++address)
+    {
+        seed = seed * 1103515245 + 12345;
+        computer.cpu()->write( static_cast<uint16_t>(address), static_cast<uint8_t>(seed >> 16) );
+    }
+
+    runner.run( "InstructionExecutor::disassemble 64K", 1, 64 * 1024, [&computer]()
+    {
+        KeepResult( computer.cpu()->disassemble( 0x0000, 0xFFFF ) );
+    });
+}
+
+static void WriteBlock(BenchmarkRunner &runner)
+{
+    Computer computer;
+    const std::vector<uint8_t> image( 64 * 1024, 0xEA );
+
+    // As in loading a whole memory image
+    runner.run( "Computer::writeBlock 64K", 1, image.size(), [&computer, &image]()
+    {
+        computer.writeBlock( 0x0000, image.data(), image.size() );
+    });
+}
+
+static void StateHash(BenchmarkRunner &runner)
+{
+    Computer computer;
+
+    LoadLoop( computer, OpcodeClasses.front().sequence );
+    runner.run( "Computer::stateHash", 1, 64 * 1024, [&computer]()
+    {
+        KeepResult( computer.stateHash() );
+    });
+}
+
+static void RenderPageView(BenchmarkRunner &runner)
+{
+    Computer computer;
+    auto     model = std::make_shared<RamBusDeviceView>();
+    auto     screen = ftxui::Screen::Create( ftxui::Dimension::Fixed(80), ftxui::Dimension::Fixed(20) );
+    int      program_counter = ProgramAddress;
+
+    model->setModel( computer.ram() );
+    model->setPage( ProgramAddress >> 8 );
+
+    runner.run( "PageView render", 1, 0, [&]()
+    {
+        ftxui::Render( screen, pageview( model, ftxui::Ref<int>(0x10), ftxui::Ref<int>(&program_counter), false ) );
+    });
+}
+
+void Run(BenchmarkRunner &runner)
+{
+    Clock( runner );
+    RunBatch( runner );
+    StepInstruction( runner );
+    DirectPages( runner );
+    Disassemble( runner );
+    WriteBlock( runner );
+    StateHash( runner );
+    RenderPageView( runner );
+}
+
+}
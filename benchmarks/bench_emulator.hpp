@@ -0,0 +1,11 @@
+#ifndef BENCH_EMULATOR_HPP
+#define BENCH_EMULATOR_HPP
+
+class BenchmarkRunner;
+
+namespace EmulatorBenchmarks
+{
+void Run(BenchmarkRunner &runner);
+}
+
+#endif // BENCH_EMULATOR_HPP
@@ -0,0 +1,138 @@
+#include "bench_io.hpp"
+#include "benchmark.hpp"
+#include "emulator/computer.hpp"
+#include "io/SRecord/QSRecordStream.hpp"
+#include "io/SimpleHex/QSimpleHexStream.hpp"
+#include <QBuffer>
+#include <QByteArray>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <iostream>
+
+namespace IOBenchmarks
+{
+
+static constexpr int BytesPerLine = 32;
+
+static uint8_t PatternByte(uint32_t address)
+{
+    return static_cast<uint8_t>( (address * 7) ^ (address >> 8) );
+}
+
+/* Makes S1 records covering all of memory, BytesPerLine bytes each, between
+ * the S0 header and S9 start address records a loadable file needs
+ */
+static QByteArray MakeSRecords()
+{
+    QByteArray data;
+    char       buffer[8];
+
+    data.append( "S0030000FC\n" );
+    for (uint32_t address = 0; address < 0x10000; address += BytesPerLine)
+    {
+        uint8_t checksum = BytesPerLine + 3 + (address >> 8) + (address & 0xFF);
+
+        snprintf(buffer, sizeof(buffer), "S1%02X%04X", BytesPerLine + 3, address);
+        data.append( buffer );
+        for (int i = 0; i < BytesPerLine; ++i)
+        {
+            checksum += PatternByte( address + i );
+            snprintf(buffer, sizeof(buffer), "%02X", PatternByte( address + i ));
+            data.append( buffer );
+        }
+        snprintf(buffer, sizeof(buffer), "%02X\n", static_cast<uint8_t>(~checksum));
+        data.append( buffer );
+    }
+    data.append( "S9030200FA\n" ); // Start at $0200
+    return data;
+}
+
+/* Makes SimpleHex lines covering all of memory, BytesPerLine bytes each */
+static QByteArray MakeSimpleHex()
+{
+    QByteArray data;
+    char       buffer[8];
+
+    for (uint32_t address = 0; address < 0x10000; address += BytesPerLine)
+    {
+        snprintf(buffer, sizeof(buffer), "%04X:", address);
+        data.append( buffer );
+        for (int i = 0; i < BytesPerLine; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), " %02X", PatternByte( address + i ));
+            data.append( buffer );
+        }
+        data.append( '\n' );
+    }
+    return data;
+}
+
+static void ReadSRecords(BenchmarkRunner &runner)
+{
+    QByteArray data = MakeSRecords();
+
+    runner.run( "QSRecordStream::readAll 64K", 1, data.size(), [&data]()
+    {
+        QBuffer buffer( &data );
+
+        buffer.open( QIODevice::ReadOnly );
+
+        QSRecordStream stream( &buffer );
+
+        KeepResult( stream.readAll() );
+    });
+}
+
+static void ReadSimpleHex(BenchmarkRunner &runner)
+{
+    QByteArray data = MakeSimpleHex();
+
+    runner.run( "QSimpleHexStream::readAll 64K", 1, data.size(), [&data]()
+    {
+        QBuffer buffer( &data );
+
+        buffer.open( QIODevice::ReadOnly );
+
+        QSimpleHexStream stream( &buffer );
+
+        KeepResult( stream.readAll() );
+    });
+}
+
+static void LoadProgram(BenchmarkRunner &runner)
+{
+    QTemporaryDir directory;
+
+    if ( !directory.isValid() )
+    {
+        std::cerr << "Skipping Computer::loadProgram, no temporary directory\n";
+        return;
+    }
+
+    const QString path = directory.filePath( "benchmark.s19" );
+    QFile         file( path );
+
+    if ( !file.open( QIODevice::WriteOnly ) || (file.write( MakeSRecords() ) == -1) )
+    {
+        std::cerr << "Skipping Computer::loadProgram, unable to write " << path.toStdString() << "\n";
+        return;
+    }
+    file.close();
+
+    Computer computer;
+
+    runner.run( "Computer::loadProgram 64K S19", 1, 64 * 1024, [&computer, &path]()
+    {
+        computer.loadProgram( path );
+    });
+}
+
+void Run(BenchmarkRunner &runner)
+{
+    ReadSRecords( runner );
+    ReadSimpleHex( runner );
+    LoadProgram( runner );
+}
+
+}
@@ -0,0 +1,11 @@
+#ifndef BENCH_IO_HPP
+#define BENCH_IO_HPP
+
+class BenchmarkRunner;
+
+namespace IOBenchmarks
+{
+void Run(BenchmarkRunner &runner);
+}
+
+#endif // BENCH_IO_HPP
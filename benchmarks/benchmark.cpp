@@ -0,0 +1,152 @@
+#include "benchmark.hpp"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+
+namespace
+{
+
+using clockType = std::chrono::steady_clock;
+
+double SecondsFor(uint64_t iterations, const std::function<void ()> &iteration)
+{
+    const auto start = clockType::now();
+
+    for (uint64_t i = 0; i < iterations; ++i)
+        iteration();
+    return std::chrono::duration<double>( clockType::now() - start ).count();
+}
+
+std::string FormatRate(double per_second, const char *unit)
+{
+    static const char *prefixes[] = { "", "k", "M", "G" };
+    char   buffer[32];
+    size_t prefix = 0;
+
+    while ( (per_second >= 1000.0) && (prefix + 1 < std::size(prefixes)) )
+    {
+        per_second /= 1000.0;
+        ++prefix;
+    }
+    snprintf(buffer, sizeof(buffer), "%7.2f %s%s/s", per_second, prefixes[prefix], unit);
+    return buffer;
+}
+
+}
+
+void BenchmarkRunner::run(const std::string &name, uint64_t ops_per_iteration, uint64_t bytes_per_iteration, const std::function<void ()> &iteration)
+{
+    if ( !_filter.empty() && (name.find( _filter ) == std::string::npos) )
+        return;
+
+    const double sample_seconds = std::chrono::duration<double>( SampleTime ).count();
+
+    // Warm up the caches and find how many iterations fill a sample
+    uint64_t iterations = 1;
+    double   seconds = SecondsFor( iterations, iteration );
+
+    while ( seconds < sample_seconds / 10 )
+    {
+        iterations *= 2;
+        seconds = SecondsFor( iterations, iteration );
+    }
+    iterations = std::max<uint64_t>( 1, static_cast<uint64_t>( iterations * sample_seconds / seconds ) );
+
+    std::vector<double> ns_per_op;
+
+    for (int sample = 0; sample < SampleCount; ++sample)
+        ns_per_op.push_back( SecondsFor( iterations, iteration ) * 1e9 / static_cast<double>(iterations * ops_per_iteration) );
+    std::sort( ns_per_op.begin(), ns_per_op.end() );
+
+    Result result;
+
+    result.name = name;
+    result.ns_per_op = ns_per_op[ns_per_op.size() / 2];
+    result.ops_per_second = 1e9 / result.ns_per_op;
+    if ( bytes_per_iteration != 0 )
+        result.bytes_per_second = result.ops_per_second * static_cast<double>(bytes_per_iteration) / static_cast<double>(ops_per_iteration);
+    result.spread = (ns_per_op.back() - ns_per_op.front()) / result.ns_per_op;
+
+    char buffer[160];
+
+    snprintf(buffer, sizeof(buffer), "%-40s %12.2f ns/op  %s  %s  +/-%4.1f%%\n",
+             name.c_str(),
+             result.ns_per_op,
+             FormatRate( result.ops_per_second, "op" ).c_str(),
+             (result.bytes_per_second != 0.0) ? FormatRate( result.bytes_per_second, "B" ).c_str() : "              ",
+             result.spread * 50.0);
+    std::cout << buffer << std::flush;
+
+    _results.push_back( std::move(result) );
+}
+
+bool BenchmarkRunner::saveBaseline(const QString &path) const
+{
+    QJsonObject benchmarks;
+
+    for (const Result &iCurrentResult : _results)
+    {
+        QJsonObject entry;
+
+        entry["ns_per_op"] = iCurrentResult.ns_per_op;
+        benchmarks[ QString::fromStdString( iCurrentResult.name ) ] = entry;
+    }
+
+    QJsonObject root;
+    QFile       file( path );
+
+    root["benchmarks"] = benchmarks;
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+        return false;
+
+    return file.write( QJsonDocument( root ).toJson() ) != -1;
+}
+
+int BenchmarkRunner::compareWithBaseline(const QString &path, double tolerance, std::ostream &output) const
+{
+    QFile file( path );
+
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return -1;
+
+    const QJsonDocument document = QJsonDocument::fromJson( file.readAll() );
+
+    if ( !document.isObject() )
+        return -1;
+
+    const QJsonObject benchmarks = document.object()["benchmarks"].toObject();
+    int  regressions = 0;
+    char buffer[160];
+
+    output << "\nCompared with " << path.toStdString() << ":\n";
+    for (const Result &iCurrentResult : _results)
+    {
+        const QJsonValue baseline = benchmarks[ QString::fromStdString( iCurrentResult.name ) ].toObject()["ns_per_op"];
+
+        if ( !baseline.isDouble() || (baseline.toDouble() <= 0.0) )
+        {
+            snprintf(buffer, sizeof(buffer), "%-40s  (not in the baseline)\n", iCurrentResult.name.c_str());
+            output << buffer;
+            continue;
+        }
+
+        const double change = iCurrentResult.ns_per_op / baseline.toDouble() - 1.0;
+        const bool   regressed = change > tolerance;
+
+        if ( regressed )
+            ++regressions;
+
+        snprintf(buffer, sizeof(buffer), "%-40s %12.2f -> %12.2f ns/op  %+6.1f%%%s\n",
+                 iCurrentResult.name.c_str(),
+                 baseline.toDouble(),
+                 iCurrentResult.ns_per_op,
+                 change * 100.0,
+                 regressed ? "  REGRESSION" : "");
+        output << buffer;
+    }
+    return regressions;
+}
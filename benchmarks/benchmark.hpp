@@ -0,0 +1,89 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <QString>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+/** Times small pieces of the emulator and compares them against a baseline.
+ *
+ *  Each benchmark is a function that does a fixed amount of work.  It is run
+ *  until enough iterations are found to fill @c SampleTime, then timed over
+ *  @c SampleCount samples of that many iterations.  The median sample is
+ *  reported, so one sample disturbed by the rest of the system doesn't move
+ *  the result.
+ */
+class BenchmarkRunner
+{
+public:
+    static constexpr std::chrono::milliseconds SampleTime{ 100 };
+    static constexpr int                       SampleCount = 7;
+
+    struct Result
+    {
+        std::string name;
+        double      ns_per_op = 0.0;        ///< Median host time for one operation
+        double      ops_per_second = 0.0;
+        double      bytes_per_second = 0.0; ///< 0 when the benchmark doesn't process bytes
+        double      spread = 0.0;           ///< (slowest - fastest) / median of the samples
+    };
+
+    /** Only runs the benchmarks whose name contains this text.
+     *
+     *  @param filter The text to look for.  An empty filter runs everything.
+     */
+    void setFilter(const std::string &filter) { _filter = filter; }
+
+    /** Times a benchmark and prints its result.
+     *
+     *  @param name                The name to report and to match against the baseline
+     *  @param ops_per_iteration   How many operations one call of @p iteration does
+     *  @param bytes_per_iteration How many bytes one call of @p iteration processes, or 0
+     *  @param iteration           Does the work being measured
+     */
+    void run(const std::string &name, uint64_t ops_per_iteration, uint64_t bytes_per_iteration, const std::function<void ()> &iteration);
+
+    const std::vector<Result> &results() const { return _results; }
+
+    /** Writes the results as a baseline for later runs to compare against.
+     *
+     *  @param path The name of the JSON file to create
+     *
+     *  @return true if the file was written
+     */
+    bool saveBaseline(const QString &path) const;
+
+    /** Compares the results with a saved baseline.
+     *
+     *  @param path      The name of a file written by @c saveBaseline()
+     *  @param tolerance How much slower than the baseline is accepted, as a fraction
+     *  @param output    Where to write the comparison
+     *
+     *  @return The number of benchmarks that regressed, or -1 if the baseline couldn't be read
+     */
+    int compareWithBaseline(const QString &path, double tolerance, std::ostream &output) const;
+
+protected:
+    std::string         _filter;
+    std::vector<Result> _results;
+};
+
+/** Keeps the compiler from throwing away work whose result is never used. */
+template <typename T>
+inline void KeepResult(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void *volatile sink;
+
+    sink = &value;
+#endif
+}
+
+#endif // BENCHMARK_HPP
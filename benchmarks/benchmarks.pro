@@ -0,0 +1,73 @@
+QT -= gui
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+# Timings of a debug build say little about the real thing
+CONFIG -= debug debug_and_release
+CONFIG += release
+
+APPDIR = $$PWD/../app
+
+INCLUDEPATH += $$APPDIR
+
+SOURCES += \
+        $$APPDIR/utilities/Profiling.cpp \
+        $$APPDIR/utilities/StringConversions.cpp \
+        $$APPDIR/emulator/breakpointcondition.cpp \
+        $$APPDIR/emulator/breakpoints.cpp \
+        $$APPDIR/emulator/bus.cpp \
+        $$APPDIR/emulator/computer.cpp \
+        $$APPDIR/emulator/flightrecorder.cpp \
+        $$APPDIR/emulator/ibusdevice.cpp \
+        $$APPDIR/emulator/instructionexecutor.cpp \
+        $$APPDIR/emulator/instructionprofile.cpp \
+        $$APPDIR/emulator/memoryheatmap.cpp \
+        $$APPDIR/emulator/olc6502.cpp \
+        $$APPDIR/emulator/pageview.cpp \
+        $$APPDIR/emulator/rambusdevice.cpp \
+        $$APPDIR/emulator/rambusdeviceview.cpp \
+        $$APPDIR/emulator/sessionstatistics.cpp \
+        $$APPDIR/emulator/statehash.cpp \
+        $$APPDIR/emulator/usagemonitor.cpp \
+        $$APPDIR/emulator/writeprovenance.cpp \
+        $$APPDIR/io/SRecord/srecord.cpp \
+        $$APPDIR/io/SRecord/QSRecordStream.cpp \
+        $$APPDIR/io/SimpleHex/QSimpleHexStream.cpp \
+        $$APPDIR/io/io.cpp \
+        bench_emulator.cpp \
+        bench_io.cpp \
+        benchmark.cpp \
+        functionaltest.cpp \
+        main.cpp
+
+HEADERS += \
+        $$APPDIR/emulator/breakpointcondition.hpp \
+        $$APPDIR/emulator/breakpoints.hpp \
+        $$APPDIR/emulator/bus.hpp \
+        $$APPDIR/emulator/computer.hpp \
+        $$APPDIR/emulator/flightrecorder.hpp \
+        $$APPDIR/emulator/ibusdevice.hpp \
+        $$APPDIR/emulator/instructionexecutor.hpp \
+        $$APPDIR/emulator/instructionprofile.hpp \
+        $$APPDIR/emulator/memoryheatmap.hpp \
+        $$APPDIR/emulator/olc6502.hpp \
+        $$APPDIR/emulator/pageview.hpp \
+        $$APPDIR/emulator/rambusdevice.hpp \
+        $$APPDIR/emulator/rambusdeviceview.hpp \
+        $$APPDIR/emulator/sessionstatistics.hpp \
+        $$APPDIR/emulator/statehash.hpp \
+        $$APPDIR/emulator/usagemonitor.hpp \
+        $$APPDIR/emulator/writeprovenance.hpp \
+        $$APPDIR/io/memory_block.hpp \
+        $$APPDIR/io/SRecord/srecord.hpp \
+        $$APPDIR/io/SRecord/QSRecordStream.hpp \
+        $$APPDIR/io/SimpleHex/QSimpleHexStream.hpp \
+        $$APPDIR/io/io.hpp \
+        bench_emulator.hpp \
+        bench_io.hpp \
+        benchmark.hpp \
+        functionaltest.hpp
+
+include($$APPDIR/FTXUI.pri)
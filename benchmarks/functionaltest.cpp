@@ -0,0 +1,101 @@
+#include "functionaltest.hpp"
+#include "emulator/computer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace FunctionalTest
+{
+
+static constexpr uint32_t BatchCycles = 10000;
+static constexpr size_t   PathLength = 16;
+
+/* Tells whether the CPU is stuck on an instruction that jumps to itself.
+ *
+ * Nothing else executes the same address twice in a row.
+ */
+static bool Trapped(const FlightRecorder &recorder)
+{
+    return (recorder.size() >= 2) &&
+           (recorder.at( recorder.size() - 2 ).program_counter == recorder.last().program_counter);
+}
+
+/* Prints the instructions that led to the trap */
+static void PrintPathToTrap(const Computer &computer, std::ostream &output)
+{
+    const FlightRecorder &recorder = computer.cpu()->flightRecorder();
+    size_t trap_start = recorder.size() - 1;
+    char   buffer[32];
+
+    while ( (trap_start > 0) && (recorder.at( trap_start - 1 ).program_counter == recorder.last().program_counter) )
+        --trap_start;
+
+    output << "Instructions before the trap:\n";
+    for (size_t index = (trap_start > PathLength) ? trap_start - PathLength : 0; index <= trap_start; ++index)
+    {
+        const FlightRecorder::Entry &entry = recorder.at( index );
+
+        snprintf(buffer, sizeof(buffer), "  $%04X  %s\n",
+                 static_cast<unsigned int>(entry.program_counter),
+                 computer.cpu()->mnemonic( entry.opcode ).c_str());
+        output << buffer;
+    }
+}
+
+bool Run(const Options &options)
+{
+    Computer computer;
+
+    if ( !computer.loadProgram( options.image ) )
+    {
+        std::cerr << "Unable to load " << options.image.toStdString() << "\n";
+        return false;
+    }
+
+    // Finish the reset, then start where the test begins rather than at its reset vector
+    computer.stepInstruction();
+    computer.cpu()->registers().program_counter = options.start_address;
+    computer.cpu()->flightRecorder().clear();
+
+    const uint64_t start_ticks = computer.cpu()->clockTicks();
+    const auto     start_time = std::chrono::steady_clock::now();
+    uint64_t       cycles = 0;
+
+    while ( !Trapped( computer.cpu()->flightRecorder() ) && (cycles < options.max_cycles) )
+    {
+        computer.run( BatchCycles );
+        cycles = computer.cpu()->clockTicks() - start_ticks;
+    }
+
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+    const olc6502::addressType trap_address = computer.cpu()->flightRecorder().last().program_counter;
+    char buffer[128];
+
+    snprintf(buffer, sizeof(buffer), "%llu cycles in %.3f s, %.2f MHz emulated\n",
+             static_cast<unsigned long long>(cycles),
+             seconds,
+             (seconds > 0.0) ? cycles / seconds / 1e6 : 0.0);
+    std::cout << buffer;
+
+    if ( !Trapped( computer.cpu()->flightRecorder() ) )
+    {
+        std::cout << "FAILED: no trap within " << options.max_cycles << " cycles\n";
+        return false;
+    }
+
+    if ( trap_address != options.success_address )
+    {
+        snprintf(buffer, sizeof(buffer), "FAILED: trapped at $%04X, success is $%04X\n",
+                 static_cast<unsigned int>(trap_address),
+                 static_cast<unsigned int>(options.success_address));
+        std::cout << buffer;
+        PrintPathToTrap( computer, std::cout );
+        return false;
+    }
+
+    snprintf(buffer, sizeof(buffer), "SUCCESS: trapped at $%04X\n", static_cast<unsigned int>(trap_address));
+    std::cout << buffer;
+    return true;
+}
+
+}
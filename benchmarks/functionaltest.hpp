@@ -0,0 +1,34 @@
+#ifndef FUNCTIONALTEST_HPP
+#define FUNCTIONALTEST_HPP
+
+#include <QString>
+#include <cstdint>
+
+/** Runs a 6502 functional test image, such as Klaus Dormann's
+ *  6502_functional_test.bin, as a correctness check and a long benchmark.
+ *
+ *  The image is loaded at $0000 and run from @c start_address until it
+ *  traps, which is what these tests do both on success and on failure: an
+ *  instruction that jumps or branches to itself.  The trap is only looked for
+ *  between batches of cycles, so the run goes at the speed of @c Computer::run().
+ */
+namespace FunctionalTest
+{
+
+struct Options
+{
+    QString  image;
+    uint16_t start_address = 0x0400;
+    uint16_t success_address = 0x3469;
+    uint64_t max_cycles = 1000000000;
+};
+
+/** Runs the test and prints the cycles, the wall time and the emulated MHz.
+ *
+ *  @return true if the test trapped at the success address
+ */
+bool Run(const Options &options);
+
+}
+
+#endif // FUNCTIONALTEST_HPP
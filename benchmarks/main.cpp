@@ -0,0 +1,99 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <cstdlib>
+#include <iostream>
+#include "benchmark.hpp"
+#include "bench_emulator.hpp"
+#include "bench_io.hpp"
+#include "functionaltest.hpp"
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication   application( argc, argv );
+    QCommandLineParser parser;
+    QCommandLineOption baseline_option( "baseline", "Compare the results with the baseline in <file>.", "file" );
+    QCommandLineOption save_option( "save", "Save the results as a baseline to <file>.", "file" );
+    QCommandLineOption tolerance_option( "tolerance", "Report a regression when more than <percent> slower than the baseline.", "percent", "10" );
+    QCommandLineOption filter_option( "filter", "Only run the benchmarks whose name contains <text>.", "text" );
+    QCommandLineOption functional_test_option( "functional-test", "Run the functional test <image> instead of the benchmarks.", "image" );
+    QCommandLineOption start_option( "start", "The address the functional test starts at, in hex.", "address", "0400" );
+    QCommandLineOption success_option( "success", "The address the functional test traps at when it passes, in hex.", "address", "3469" );
+    QCommandLineOption max_cycles_option( "max-cycles", "Fail the functional test if it hasn't trapped after <count> cycles.", "count", "1000000000" );
+
+    parser.setApplicationDescription( "Times the emulator, the loaders and the views." );
+    parser.addHelpOption();
+    parser.addOption( baseline_option );
+    parser.addOption( save_option );
+    parser.addOption( tolerance_option );
+    parser.addOption( filter_option );
+    parser.addOption( functional_test_option );
+    parser.addOption( start_option );
+    parser.addOption( success_option );
+    parser.addOption( max_cycles_option );
+    parser.process( application );
+
+    bool   valid_tolerance = false;
+    double tolerance = parser.value( tolerance_option ).toDouble( &valid_tolerance ) / 100.0;
+
+    if ( !valid_tolerance )
+    {
+        std::cerr << parser.helpText().toStdString();
+        return 2;
+    }
+
+    if ( parser.isSet( functional_test_option ) )
+    {
+        FunctionalTest::Options options;
+        bool valid_start = false;
+        bool valid_success = false;
+        bool valid_max_cycles = false;
+
+        options.image = parser.value( functional_test_option );
+        options.start_address = parser.value( start_option ).toUShort( &valid_start, 16 );
+        options.success_address = parser.value( success_option ).toUShort( &valid_success, 16 );
+        options.max_cycles = parser.value( max_cycles_option ).toULongLong( &valid_max_cycles );
+        if ( !valid_start || !valid_success || !valid_max_cycles )
+        {
+            std::cerr << parser.helpText().toStdString();
+            return 2;
+        }
+
+        return FunctionalTest::Run( options ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    BenchmarkRunner runner;
+
+    runner.setFilter( parser.value( filter_option ).toStdString() );
+
+    std::cout << "Running Benchmarks..." << std::endl;
+
+    EmulatorBenchmarks::Run( runner );
+    IOBenchmarks::Run( runner );
+
+    if ( parser.isSet( save_option ) && !runner.saveBaseline( parser.value( save_option ) ) )
+    {
+        std::cerr << "Unable to write " << parser.value( save_option ).toStdString() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if ( parser.isSet( baseline_option ) )
+    {
+        const int regressions = runner.compareWithBaseline( parser.value( baseline_option ), tolerance, std::cout );
+
+        if ( regressions < 0 )
+        {
+            std::cerr << "Unable to read " << parser.value( baseline_option ).toStdString() << "\n";
+            return EXIT_FAILURE;
+        }
+        if ( regressions > 0 )
+        {
+            std::cout << regressions << " regression(s)" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "Done" << std::endl;
+
+    return EXIT_SUCCESS;
+}
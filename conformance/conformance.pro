@@ -0,0 +1,33 @@
+QT -= gui
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+# Millions of vectors are only quick with optimization
+CONFIG -= debug debug_and_release
+CONFIG += release
+
+APPDIR = $$PWD/../app
+
+INCLUDEPATH += $$APPDIR
+
+SOURCES += \
+        $$APPDIR/utilities/Profiling.cpp \
+        $$APPDIR/emulator/breakpoints.cpp \
+        $$APPDIR/emulator/flightrecorder.cpp \
+        $$APPDIR/emulator/instructionexecutor.cpp \
+        $$APPDIR/emulator/instructionprofile.cpp \
+        $$APPDIR/emulator/memoryheatmap.cpp \
+        $$APPDIR/emulator/sessionstatistics.cpp \
+        $$APPDIR/emulator/statehash.cpp \
+        $$APPDIR/emulator/usagemonitor.cpp \
+        $$APPDIR/emulator/writeprovenance.cpp \
+        conformancerunner.cpp \
+        testvectorreader.cpp \
+        main.cpp
+
+HEADERS += \
+        $$APPDIR/emulator/instructionexecutor.hpp \
+        conformancerunner.hpp \
+        testvectorreader.hpp
@@ -0,0 +1,221 @@
+#include "conformancerunner.hpp"
+#include "testvectorreader.hpp"
+#include "emulator/instructionexecutor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+
+namespace
+{
+
+/* A processor and memory to run vectors on */
+class VectorMachine
+{
+public:
+    VectorMachine()
+        :
+        _executor( _registers,
+                   [this](InstructionExecutor::addressType address, bool) { return _memory[address]; },
+                   [this](InstructionExecutor::addressType address, uint8_t data)
+                   {
+                       _memory[address] = data;
+                       _written.push_back( address );
+                   },
+                   [](uint8_t) {}, [](uint8_t) {}, [](uint8_t) {},
+                   [](uint16_t) {},
+                   [](uint8_t) {}, [](uint8_t) {} )
+    {
+    }
+
+    /** Runs a vector.
+     *
+     *  @param vector   The vector to run
+     *  @param mismatch Receives what differed, if anything did
+     *
+     *  @return true if everything matched
+     */
+    bool run(const TestVector &vector, std::string &mismatch)
+    {
+        const uint64_t start_ticks = _executor.clock_ticks;
+
+        for (const auto &[address, value] : vector.initial.ram)
+            _memory[address] = value;
+        _registers.program_counter = vector.initial.pc;
+        _registers.stack_pointer = vector.initial.s;
+        _registers.a = vector.initial.a;
+        _registers.x = vector.initial.x;
+        _registers.y = vector.initial.y;
+        _registers.status = vector.initial.p;
+        _written.clear();
+
+        do
+            _executor.clock();
+        while ( !_executor.complete() );
+
+        mismatch.clear();
+        compare( "pc", vector.final.pc, _registers.program_counter, mismatch );
+        compare( "s", vector.final.s, _registers.stack_pointer, mismatch );
+        compare( "a", vector.final.a, _registers.a, mismatch );
+        compare( "x", vector.final.x, _registers.x, mismatch );
+        compare( "y", vector.final.y, _registers.y, mismatch );
+        compare( "p", vector.final.p, _registers.status, mismatch );
+        compare( "cycles", vector.cycles, static_cast<unsigned>(_executor.clock_ticks - start_ticks), mismatch );
+
+        char name[16];
+
+        for (const auto &[address, value] : vector.final.ram)
+        {
+            snprintf(name, sizeof(name), "$%04X", static_cast<unsigned int>(address));
+            compare( name, value, _memory[address], mismatch );
+        }
+
+        for (uint16_t address : _written)
+        {
+            auto listed = std::find_if( vector.final.ram.begin(), vector.final.ram.end(),
+                                        [address](const auto &entry) { return entry.first == address; } );
+
+            if ( listed == vector.final.ram.end() )
+            {
+                snprintf(name, sizeof(name), "$%04X", static_cast<unsigned int>(address));
+                append( mismatch, std::string(name) + " written unexpectedly" );
+            }
+        }
+
+        // Leave memory zeroed for the next vector
+        for (const auto &entry : vector.initial.ram)
+            _memory[entry.first] = 0;
+        for (uint16_t address : _written)
+            _memory[address] = 0;
+
+        return mismatch.empty();
+    }
+
+protected:
+    std::array<uint8_t, 64 * 1024> _memory{};
+    std::vector<uint16_t>          _written;
+    Registers                      _registers;
+    InstructionExecutor            _executor;
+
+    static void append(std::string &mismatch, const std::string &text)
+    {
+        if ( !mismatch.empty() )
+            mismatch += ", ";
+        mismatch += text;
+    }
+
+    static void compare(const char *name, unsigned expected, unsigned actual, std::string &mismatch)
+    {
+        if ( expected == actual )
+            return;
+
+        char buffer[64];
+
+        snprintf(buffer, sizeof(buffer), "%s expected %u got %u", name, expected, actual);
+        append( mismatch, buffer );
+    }
+};
+
+bool ReadWholeFile(const std::string &path, std::string &text)
+{
+    FILE *file = fopen( path.c_str(), "rb" );
+
+    if ( !file )
+        return false;
+
+    char   buffer[64 * 1024];
+    size_t count;
+
+    text.clear();
+    while ( (count = fread( buffer, 1, sizeof(buffer), file )) > 0 )
+        text.append( buffer, count );
+
+    const bool read_error = ferror( file ) != 0;
+
+    fclose( file );
+    return !read_error;
+}
+
+void Merge(ConformanceRunner::Results &into, const ConformanceRunner::Results &from)
+{
+    for (size_t opcode = 0; opcode < into.size(); ++opcode)
+    {
+        into[opcode].run += from[opcode].run;
+        into[opcode].failed += from[opcode].failed;
+        for (const std::string &iCurrentMismatch : from[opcode].mismatches)
+            if ( into[opcode].mismatches.size() < ConformanceRunner::KeptMismatches )
+                into[opcode].mismatches.push_back( iCurrentMismatch );
+    }
+}
+
+}
+
+bool ConformanceRunner::RunFile(const std::string &path, Results &results, std::string &error)
+{
+    // The machine is big, so each thread keeps one on the heap rather than the stack
+    thread_local std::unique_ptr<VectorMachine> machine = std::make_unique<VectorMachine>();
+    std::string text;
+
+    if ( !ReadWholeFile( path, text ) )
+    {
+        error = path + ": unable to read";
+        return false;
+    }
+
+    TestVectorReader reader( text );
+    TestVector       vector;
+    std::string      mismatch;
+
+    while ( reader.next( vector ) )
+    {
+        // The opcode is whatever the vector has at its program counter
+        auto opcode_entry = std::find_if( vector.initial.ram.begin(), vector.initial.ram.end(),
+                                          [&vector](const auto &entry) { return entry.first == vector.initial.pc; } );
+        OpcodeResult &result = results[ (opcode_entry != vector.initial.ram.end()) ? opcode_entry->second : 0 ];
+
+        ++result.run;
+        if ( !machine->run( vector, mismatch ) )
+        {
+            ++result.failed;
+            if ( result.mismatches.size() < KeptMismatches )
+                result.mismatches.push_back( vector.name + ": " + mismatch );
+        }
+    }
+
+    if ( reader.failed() )
+    {
+        error = path + ": " + reader.error();
+        return false;
+    }
+    return true;
+}
+
+auto ConformanceRunner::RunFiles(const std::vector<std::string> &paths, unsigned threads, std::vector<std::string> &errors) -> Results
+{
+    std::vector<Results>     thread_results( std::max(1u, threads) );
+    std::vector<std::string> file_errors( paths.size() );
+    std::atomic<size_t>      next_file{ 0 };
+    std::vector<std::thread> workers;
+
+    for (Results &iCurrentResults : thread_results)
+    {
+        workers.emplace_back( [&paths, &file_errors, &next_file, &iCurrentResults]()
+        {
+            for (size_t file = next_file++; file < paths.size(); file = next_file++)
+                RunFile( paths[file], iCurrentResults, file_errors[file] );
+        });
+    }
+    for (std::thread &iCurrentWorker : workers)
+        iCurrentWorker.join();
+
+    Results results;
+
+    for (const Results &iCurrentResults : thread_results)
+        Merge( results, iCurrentResults );
+    for (std::string &iCurrentError : file_errors)
+        if ( !iCurrentError.empty() )
+            errors.push_back( std::move(iCurrentError) );
+    return results;
+}
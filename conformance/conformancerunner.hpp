@@ -0,0 +1,56 @@
+#ifndef CONFORMANCERUNNER_HPP
+#define CONFORMANCERUNNER_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/** Runs test vectors through @c InstructionExecutor and tallies the results per opcode.
+ *
+ *  Each vector sets up the registers and the bytes of RAM it uses, executes
+ *  exactly one instruction and compares the registers, RAM and number of
+ *  cycles with what it expects.  A write to an address the vector doesn't
+ *  list in its final RAM is a mismatch too.
+ *
+ *  Files are shared out to worker threads, each with its own executor and
+ *  64KB of memory, so nothing is locked while vectors run.
+ */
+class ConformanceRunner
+{
+public:
+    /// How many mismatch descriptions are kept per opcode
+    static constexpr size_t KeptMismatches = 3;
+
+    struct OpcodeResult
+    {
+        uint64_t                 run = 0;
+        uint64_t                 failed = 0;
+        std::vector<std::string> mismatches; ///< The first few, as "name: what differed"
+    };
+
+    using Results = std::array<OpcodeResult, 256>;
+
+    /** Runs the vectors in every file.
+     *
+     *  @param paths   The JSON files to read
+     *  @param threads How many worker threads to use
+     *  @param errors  Receives a message for each file that couldn't be read
+     *
+     *  @return The results for every opcode
+     */
+    static Results RunFiles(const std::vector<std::string> &paths, unsigned threads, std::vector<std::string> &errors);
+
+    /** Runs the vectors in one file on the calling thread.
+     *
+     *  @param path    The JSON file to read
+     *  @param results Has the file's results added to it
+     *  @param error   Receives a message if the file couldn't be read
+     *
+     *  @return true if the whole file was read
+     */
+    static bool RunFile(const std::string &path, Results &results, std::string &error);
+};
+
+#endif // CONFORMANCERUNNER_HPP
@@ -0,0 +1,104 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "conformancerunner.hpp"
+#include "emulator/instructionexecutor.hpp"
+
+
+static std::vector<std::string> JsonFilesIn(const QStringList &arguments)
+{
+    std::vector<std::string> paths;
+
+    for (const QString &iCurrentArgument : arguments)
+    {
+        QFileInfo info( iCurrentArgument );
+
+        if ( !info.isDir() )
+        {
+            paths.push_back( iCurrentArgument.toStdString() );
+            continue;
+        }
+
+        const QDir directory( iCurrentArgument );
+
+        for (const QString &iCurrentName : directory.entryList( QStringList{ "*.json" }, QDir::Files, QDir::Name ))
+            paths.push_back( directory.filePath( iCurrentName ).toStdString() );
+    }
+    return paths;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication   application( argc, argv );
+    QCommandLineParser parser;
+    QCommandLineOption threads_option( "threads", "Run on <count> threads.", "count",
+                                       QString::number( std::max(1u, std::thread::hardware_concurrency()) ) );
+
+    parser.setApplicationDescription( "Checks InstructionExecutor against per-opcode test vectors." );
+    parser.addHelpOption();
+    parser.addOption( threads_option );
+    parser.addPositionalArgument( "vectors", "JSON files of test vectors, or directories of them.", "vectors..." );
+    parser.process( application );
+
+    bool valid_threads = false;
+    const unsigned threads = parser.value( threads_option ).toUInt( &valid_threads );
+    const std::vector<std::string> paths = JsonFilesIn( parser.positionalArguments() );
+
+    if ( !valid_threads || (threads == 0) || paths.empty() )
+    {
+        std::cerr << parser.helpText().toStdString();
+        return 2;
+    }
+
+    std::cout << "Running " << paths.size() << " file(s) on " << threads << " thread(s)..." << std::endl;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::string> errors;
+    const ConformanceRunner::Results results = ConformanceRunner::RunFiles( paths, threads, errors );
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+
+    // Only the mnemonics are wanted, so the executor is never run
+    Registers registers;
+    const InstructionExecutor names( registers, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr );
+    uint64_t total_run = 0;
+    uint64_t total_failed = 0;
+    char     buffer[96];
+
+    for (size_t opcode = 0; opcode < results.size(); ++opcode)
+    {
+        const ConformanceRunner::OpcodeResult &result = results[opcode];
+
+        total_run += result.run;
+        total_failed += result.failed;
+        if ( result.failed == 0 )
+            continue;
+
+        snprintf(buffer, sizeof(buffer), "$%02X %s %s: %llu of %llu failed\n",
+                 static_cast<unsigned int>(opcode),
+                 names.mnemonic( static_cast<uint8_t>(opcode) ).c_str(),
+                 names.addressingMode( static_cast<uint8_t>(opcode) ).c_str(),
+                 static_cast<unsigned long long>(result.failed),
+                 static_cast<unsigned long long>(result.run));
+        std::cout << buffer;
+        for (const std::string &iCurrentMismatch : result.mismatches)
+            std::cout << "    " << iCurrentMismatch << "\n";
+    }
+
+    for (const std::string &iCurrentError : errors)
+        std::cerr << iCurrentError << "\n";
+
+    snprintf(buffer, sizeof(buffer), "%llu vectors, %llu failed, in %.2f s (%.0f vectors/s)\n",
+             static_cast<unsigned long long>(total_run),
+             static_cast<unsigned long long>(total_failed),
+             seconds,
+             (seconds > 0.0) ? total_run / seconds : 0.0);
+    std::cout << buffer;
+
+    return ((total_failed == 0) && errors.empty()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
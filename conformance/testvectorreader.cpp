@@ -0,0 +1,282 @@
+#include "testvectorreader.hpp"
+#include <cstdio>
+
+
+TestVectorReader::TestVectorReader(std::string_view text)
+    :
+    _text( text )
+{
+}
+
+bool TestVectorReader::next(TestVector &vector)
+{
+    if ( failed() )
+        return false;
+
+    if ( !_started )
+    {
+        _started = true;
+        if ( !expect('[') )
+            return false;
+        if ( consume(']') )
+            return false;
+    }
+    else if ( consume(']') )
+        return false;
+    else if ( !expect(',') )
+        return false;
+
+    if ( !expect('{') )
+        return false;
+
+    vector.cycles = 0;
+    if ( consume('}') )
+        return true;
+
+    do
+    {
+        std::string_view key;
+
+        if ( !readString(key) || !expect(':') )
+            return false;
+
+        if ( key == "name" )
+        {
+            std::string_view name;
+
+            if ( !readString(name) )
+                return false;
+            vector.name.assign( name.data(), name.size() );
+        }
+        else if ( key == "initial" )
+        {
+            if ( !readState(vector.initial) )
+                return false;
+        }
+        else if ( key == "final" )
+        {
+            if ( !readState(vector.final) )
+                return false;
+        }
+        else if ( key == "cycles" )
+        {
+            if ( !countArray(vector.cycles) )
+                return false;
+        }
+        else if ( !skipValue() )
+            return false;
+    }
+    while ( consume(',') );
+
+    return expect('}');
+}
+
+void TestVectorReader::skipWhitespace()
+{
+    while ( (_position < _text.size()) &&
+            ((_text[_position] == ' ') || (_text[_position] == '\n') || (_text[_position] == '\r') || (_text[_position] == '\t')) )
+        ++_position;
+}
+
+bool TestVectorReader::consume(char expected)
+{
+    skipWhitespace();
+    if ( (_position < _text.size()) && (_text[_position] == expected) )
+    {
+        ++_position;
+        return true;
+    }
+    return false;
+}
+
+bool TestVectorReader::expect(char expected)
+{
+    if ( consume(expected) )
+        return true;
+
+    char message[32];
+
+    snprintf(message, sizeof(message), "expected '%c'", expected);
+    return fail(message);
+}
+
+bool TestVectorReader::readString(std::string_view &value)
+{
+    if ( !expect('"') )
+        return false;
+
+    const size_t start = _position;
+
+    // Escapes are skipped over, not decoded.  Names and keys don't use them.
+    while ( (_position < _text.size()) && (_text[_position] != '"') )
+        _position += (_text[_position] == '\\') ? 2 : 1;
+
+    if ( _position >= _text.size() )
+        return fail("unterminated string");
+
+    value = _text.substr( start, _position - start );
+    ++_position;
+    return true;
+}
+
+bool TestVectorReader::readNumber(uint32_t &value)
+{
+    skipWhitespace();
+
+    const size_t start = _position;
+
+    value = 0;
+    while ( (_position < _text.size()) && (_text[_position] >= '0') && (_text[_position] <= '9') )
+        value = value * 10 + static_cast<uint32_t>(_text[_position++] - '0');
+
+    return (_position != start) || fail("expected a number");
+}
+
+bool TestVectorReader::readState(TestVector::State &state)
+{
+    if ( !expect('{') )
+        return false;
+
+    state.ram.clear();
+    if ( consume('}') )
+        return true;
+
+    do
+    {
+        std::string_view key;
+        uint32_t         value = 0;
+
+        if ( !readString(key) || !expect(':') )
+            return false;
+
+        if ( key == "ram" )
+        {
+            if ( !readRam(state.ram) )
+                return false;
+            continue;
+        }
+
+        if ( (key != "pc") && (key != "s") && (key != "a") && (key != "x") && (key != "y") && (key != "p") )
+        {
+            if ( !skipValue() )
+                return false;
+            continue;
+        }
+
+        if ( !readNumber(value) )
+            return false;
+
+        switch ( key[0] )
+        {
+        case 'p':
+            if ( key.size() == 2 )
+                state.pc = static_cast<uint16_t>(value);
+            else
+                state.p = static_cast<uint8_t>(value);
+            break;
+        case 's':
+            state.s = static_cast<uint8_t>(value);
+            break;
+        case 'a':
+            state.a = static_cast<uint8_t>(value);
+            break;
+        case 'x':
+            state.x = static_cast<uint8_t>(value);
+            break;
+        case 'y':
+            state.y = static_cast<uint8_t>(value);
+            break;
+        }
+    }
+    while ( consume(',') );
+
+    return expect('}');
+}
+
+bool TestVectorReader::readRam(std::vector<std::pair<uint16_t, uint8_t>> &ram)
+{
+    if ( !expect('[') )
+        return false;
+    if ( consume(']') )
+        return true;
+
+    do
+    {
+        uint32_t address = 0;
+        uint32_t value = 0;
+
+        if ( !expect('[') || !readNumber(address) || !expect(',') || !readNumber(value) || !expect(']') )
+            return false;
+        ram.emplace_back( static_cast<uint16_t>(address), static_cast<uint8_t>(value) );
+    }
+    while ( consume(',') );
+
+    return expect(']');
+}
+
+bool TestVectorReader::countArray(unsigned &count)
+{
+    count = 0;
+    if ( !expect('[') )
+        return false;
+    if ( consume(']') )
+        return true;
+
+    do
+    {
+        if ( !skipValue() )
+            return false;
+        ++count;
+    }
+    while ( consume(',') );
+
+    return expect(']');
+}
+
+bool TestVectorReader::skipValue()
+{
+    skipWhitespace();
+    if ( _position >= _text.size() )
+        return fail("unexpected end of file");
+
+    std::string_view string_value;
+    unsigned         count = 0;
+
+    switch ( _text[_position] )
+    {
+    case '"':
+        return readString(string_value);
+    case '[':
+        return countArray(count);
+    case '{':
+        ++_position;
+        if ( consume('}') )
+            return true;
+        do
+        {
+            if ( !readString(string_value) || !expect(':') || !skipValue() )
+                return false;
+        }
+        while ( consume(',') );
+        return expect('}');
+    default:
+        // A number, true, false or null
+        while ( (_position < _text.size()) &&
+                (_text[_position] != ',') && (_text[_position] != ']') && (_text[_position] != '}') &&
+                (_text[_position] != ' ') && (_text[_position] != '\n') && (_text[_position] != '\r') && (_text[_position] != '\t') )
+            ++_position;
+        return true;
+    }
+}
+
+bool TestVectorReader::fail(const char *message)
+{
+    if ( _error.empty() )
+    {
+        char buffer[96];
+
+        snprintf(buffer, sizeof(buffer), "%s at offset %zu", message, _position);
+        _error = buffer;
+    }
+    return false;
+}
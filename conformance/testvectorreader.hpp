@@ -0,0 +1,82 @@
+#ifndef TESTVECTORREADER_HPP
+#define TESTVECTORREADER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+/** One instruction's worth of processor test, in the layout of the
+ *  SingleStepTests (ProcessorTests) 6502 vectors:
+ *
+ *      { "name": "a9 12 34",
+ *        "initial": { "pc": 1234, "s": 253, "a": 0, "x": 0, "y": 0, "p": 36, "ram": [ [1234, 169], [1235, 18] ] },
+ *        "final":   { ... },
+ *        "cycles":  [ [1234, 169, "read"], [1235, 18, "read"] ] }
+ *
+ *  Only the number of bus cycles is kept, not what happened on each.
+ */
+struct TestVector
+{
+    struct State
+    {
+        uint16_t pc = 0;
+        uint8_t  s = 0;
+        uint8_t  a = 0;
+        uint8_t  x = 0;
+        uint8_t  y = 0;
+        uint8_t  p = 0;
+        std::vector<std::pair<uint16_t, uint8_t>> ram;
+    };
+
+    std::string name;
+    State       initial;
+    State       final;
+    unsigned    cycles = 0;
+};
+
+/** Reads test vectors one at a time from the text of a JSON file.
+ *
+ *  The file is a single array of vectors.  This is not a general JSON
+ *  parser: it only builds what a @c TestVector holds and skips over
+ *  anything else, which makes it fast enough to stream millions of vectors.
+ */
+class TestVectorReader
+{
+public:
+    /// @param text The whole file.  It must outlive the reader.
+    explicit TestVectorReader(std::string_view text);
+
+    /** Reads the next vector.
+     *
+     *  @param vector Receives the vector.  Its vectors are reused, so
+     *                passing the same one each time saves allocations.
+     *
+     *  @return false at the end of the array or on an error
+     */
+    bool next(TestVector &vector);
+
+    bool               failed() const { return !_error.empty(); }
+    const std::string &error() const { return _error; }
+
+protected:
+    std::string_view _text;
+    size_t           _position = 0;
+    bool             _started = false;
+    std::string      _error;
+
+    void skipWhitespace();
+    bool consume(char expected);
+    bool expect(char expected);
+    bool readString(std::string_view &value);
+    bool readNumber(uint32_t &value);
+    bool readState(TestVector::State &state);
+    bool readRam(std::vector<std::pair<uint16_t, uint8_t>> &ram);
+    bool countArray(unsigned &count);
+    bool skipValue();
+    bool fail(const char *message);
+};
+
+#endif // TESTVECTORREADER_HPP
@@ -2,6 +2,14 @@
 #include <iostream>
 #include "test_srecord.hpp"
 #include "test_simplehex.hpp"
+#include "test_breakpointcondition.hpp"
+#include "test_lockstep.hpp"
+#include "test_statehash.hpp"
+#include "test_snapshots.hpp"
+#include "test_clockpacer.hpp"
+#include "test_batchsizer.hpp"
+#include "test_busdevice.hpp"
+#include "test_directpages.hpp"
 
 
 int main(void)
@@ -10,6 +18,14 @@ int main(void)
 
     SRecordTests::Run();
     SimpleHexTests::Run();
+    BreakpointConditionTests::Run();
+    LockstepTests::Run();
+    StateHashTests::Run();
+    SnapshotTests::Run();
+    ClockPacerTests::Run();
+    BatchSizerTests::Run();
+    BusDeviceTests::Run();
+    DirectPagesTests::Run();
 
     std::cout << "Done" << std::endl;
 
@@ -0,0 +1,63 @@
+#include "test_batchsizer.hpp"
+#include "batchsizer.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace BatchSizerTests
+{
+
+using namespace std::chrono_literals;
+
+void BatchesTakeTheTargetTime()
+{
+    std::cout << "BatchesTakeTheTargetTime...";
+
+    BatchSizer sizer;
+
+    assert( sizer.cycles() == BatchSizer::InitialCycles );
+
+    // 10000 cycles in 1ms is 10 cycles/us, so 4ms is 40000 cycles
+    sizer.setTarget( 4ms );
+    sizer.ran( 10000, 1ms );
+    assert( sizer.cycles() == 40000 );
+
+    // Slowing down to 5 cycles/us is followed a quarter of the way at a time
+    for (int batch = 0; batch < 40; ++batch)
+        sizer.ran( 20000, 4ms );
+    assert( sizer.cycles() >= 19990 && sizer.cycles() <= 20010 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void SizesAreBounded()
+{
+    std::cout << "SizesAreBounded...";
+
+    BatchSizer sizer;
+
+    sizer.setTarget( 4ms );
+    sizer.ran( 1, 1s );
+    assert( sizer.cycles() == BatchSizer::MinimumCycles );
+
+    BatchSizer fast;
+
+    fast.setTarget( 1s );
+    fast.ran( 1'000'000, 1ms );
+    assert( fast.cycles() == BatchSizer::MaximumCycles );
+
+    // Nothing is learned from a batch too short to time
+    fast.ran( 10, 0ns );
+    assert( fast.cycles() == BatchSizer::MaximumCycles );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running BatchSizerTests" << std::endl;
+
+    BatchesTakeTheTargetTime();
+    SizesAreBounded();
+}
+
+}
@@ -0,0 +1,9 @@
+#ifndef TEST_BATCHSIZER_HPP
+#define TEST_BATCHSIZER_HPP
+
+namespace BatchSizerTests
+{
+void Run();
+}
+
+#endif // TEST_BATCHSIZER_HPP
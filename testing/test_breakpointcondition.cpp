@@ -0,0 +1,249 @@
+#include "test_breakpointcondition.hpp"
+#include "emulator/breakpointcondition.hpp"
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cassert>
+
+namespace BreakpointConditionTests
+{
+
+void CompareRegisterAndMemory()
+{
+    std::cout << "CompareRegisterAndMemory...";
+
+    BreakpointCondition::memoryType memory{};
+    Registers registers;
+    auto condition = BreakpointCondition::Compile("A == $FF && mem[$10] > 3");
+
+    assert( condition.has_value() );
+
+    registers.a = 0xFF;
+    memory[0x10] = 4;
+    assert( condition->evaluate( registers, memory ) );
+
+    memory[0x10] = 3;
+    assert( !condition->evaluate( registers, memory ) );
+
+    registers.a = 0xFE;
+    memory[0x10] = 4;
+    assert( !condition->evaluate( registers, memory ) );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void NumberFormats()
+{
+    std::cout << "NumberFormats...";
+
+    BreakpointCondition::memoryType memory{};
+    Registers registers;
+
+    assert( BreakpointCondition::Compile("$1F")->value( registers, memory ) == 0x1F );
+    assert( BreakpointCondition::Compile("0x1f")->value( registers, memory ) == 0x1F );
+    assert( BreakpointCondition::Compile("%11111")->value( registers, memory ) == 0x1F );
+    assert( BreakpointCondition::Compile("31")->value( registers, memory ) == 0x1F );
+
+    // After a value, '%' is the modulo operator
+    assert( BreakpointCondition::Compile("%101 % 3")->value( registers, memory ) == 2 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void OperatorPrecedence()
+{
+    std::cout << "OperatorPrecedence...";
+
+    BreakpointCondition::memoryType memory{};
+    Registers registers;
+
+    assert( BreakpointCondition::Compile("1 + 2 * 3")->value( registers, memory ) == 7 );
+    assert( BreakpointCondition::Compile("(1 + 2) * 3")->value( registers, memory ) == 9 );
+    assert( BreakpointCondition::Compile("1 | 2 == 2")->value( registers, memory ) == 1 );
+    assert( BreakpointCondition::Compile("-2 - -3")->value( registers, memory ) == 1 );
+    assert( BreakpointCondition::Compile("~0 & $FF")->value( registers, memory ) == 0xFF );
+    assert( BreakpointCondition::Compile("1 << 4 >> 2")->value( registers, memory ) == 4 );
+    assert( BreakpointCondition::Compile("7 / 0")->value( registers, memory ) == 0 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void LogicalOperatorsShortCircuit()
+{
+    std::cout << "LogicalOperatorsShortCircuit...";
+
+    BreakpointCondition::memoryType memory{};
+    Registers registers;
+
+    assert( BreakpointCondition::Compile("0 && 1")->value( registers, memory ) == 0 );
+    assert( BreakpointCondition::Compile("5 && 7")->value( registers, memory ) == 1 );
+    assert( BreakpointCondition::Compile("5 || 0")->value( registers, memory ) == 1 );
+    assert( BreakpointCondition::Compile("0 || 0")->value( registers, memory ) == 0 );
+    assert( BreakpointCondition::Compile("0 || 0 || 9")->value( registers, memory ) == 1 );
+    assert( BreakpointCondition::Compile("1 && 0 || 1 && 2")->value( registers, memory ) == 1 );
+    assert( BreakpointCondition::Compile("!(1 && 0)")->value( registers, memory ) == 1 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void RegistersFlagsAndWords()
+{
+    std::cout << "RegistersFlagsAndWords...";
+
+    BreakpointCondition::memoryType memory{};
+    Registers registers;
+
+    registers.x = 0x12;
+    registers.y = 0x34;
+    registers.stack_pointer = 0xFD;
+    registers.program_counter = 0xC000;
+    registers.status = C | N;
+    memory[0xFFFC] = 0x00;
+    memory[0xFFFD] = 0xC0;
+
+    assert( BreakpointCondition::Compile("x == $12 && Y == $34")->evaluate( registers, memory ) );
+    assert( BreakpointCondition::Compile("SP == $FD && pc == $C000")->evaluate( registers, memory ) );
+    assert( BreakpointCondition::Compile("C && N && !Z")->evaluate( registers, memory ) );
+    assert( BreakpointCondition::Compile("P")->value( registers, memory ) == (C | N) );
+    assert( BreakpointCondition::Compile("word[$FFFC] == pc")->evaluate( registers, memory ) );
+    assert( BreakpointCondition::Compile("mem[$FFFC + 1]")->value( registers, memory ) == 0xC0 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void InvalidExpressionsAreReported()
+{
+    std::cout << "InvalidExpressionsAreReported...";
+
+    std::string error;
+
+    assert( !BreakpointCondition::Compile("", &error).has_value() );
+    assert( !error.empty() );
+
+    error.clear();
+    assert( !BreakpointCondition::Compile("A ==", &error).has_value() );
+    assert( !error.empty() );
+
+    error.clear();
+    assert( !BreakpointCondition::Compile("mem[$10", &error).has_value() );
+    assert( !error.empty() );
+
+    error.clear();
+    assert( !BreakpointCondition::Compile("Q == 1", &error).has_value() );
+    assert( error.find("Q") != std::string::npos );
+
+    assert( !BreakpointCondition::Compile("$").has_value() );
+    assert( !BreakpointCondition::Compile("12ab").has_value() );
+    assert( !BreakpointCondition::Compile("1 2").has_value() );
+    assert( !BreakpointCondition::Compile("$FFFFFFFFFF").has_value() );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void OverflowWrapsAround()
+{
+    std::cout << "OverflowWrapsAround...";
+
+    BreakpointCondition::memoryType memory{};
+    Registers registers;
+
+    const auto value_of = [&](const char *expression)
+    {
+        const auto condition = BreakpointCondition::Compile( expression );
+
+        assert( condition.has_value() );
+        return condition->value( registers, memory );
+    };
+
+    // INT32_MIN / -1 and INT32_MIN % -1 would trap
+    const BreakpointCondition::valueType quotient  = value_of("(-2147483647 - 1) / -1");
+    const BreakpointCondition::valueType remainder = value_of("(-2147483647 - 1) % -1");
+
+    assert( quotient == INT32_MIN );
+    assert( remainder == 0 );
+
+    const BreakpointCondition::valueType sum        = value_of("2147483647 + 1");
+    const BreakpointCondition::valueType difference = value_of("-2147483647 - 2");
+    const BreakpointCondition::valueType product    = value_of("65536 * 65536 + 65536 * 32768");
+    const BreakpointCondition::valueType negated    = value_of("-(-2147483647 - 1)");
+    const BreakpointCondition::valueType word       = value_of("word[2147483647]");
+
+    assert( sum == INT32_MIN );
+    assert( difference == INT32_MAX );
+    assert( product == INT32_MIN );
+    assert( negated == INT32_MIN );
+    assert( word == 0 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void DeepNestingIsRefused()
+{
+    std::cout << "DeepNestingIsRefused...";
+
+    std::string error;
+
+    const bool nested_parentheses = BreakpointCondition::Compile( std::string(100000, '(') + "1" + std::string(100000, ')'), &error ).has_value();
+
+    assert( !nested_parentheses );
+    assert( error == "Expression is too deeply nested" );
+
+    error.clear();
+    const bool nested_operators = BreakpointCondition::Compile( std::string(100000, '-') + "1", &error ).has_value();
+
+    assert( !nested_operators );
+    assert( error == "Expression is too deeply nested" );
+
+    const bool nested_brackets = BreakpointCondition::Compile( "mem[mem[mem[mem[$10]]]]" ).has_value();
+    const bool reasonable      = BreakpointCondition::Compile( std::string(100, '(') + "1" + std::string(100, ')') ).has_value();
+
+    assert( nested_brackets );
+    assert( reasonable );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void MemoryThroughADelegate()
+{
+    std::cout << "MemoryThroughADelegate...";
+
+    Registers registers;
+    std::vector<uint16_t> addresses_read;
+    const BreakpointCondition::readDelegate read_memory = [&addresses_read](uint16_t address)
+    {
+        addresses_read.push_back( address );
+        return static_cast<uint8_t>(address);
+    };
+
+    const bool holds = BreakpointCondition::Compile("mem[$10] == $10 && word[$12FF] == $00FF")->evaluate( registers, read_memory );
+
+    assert( holds );
+    assert( (addresses_read == std::vector<uint16_t>{ 0x0010, 0x12FF, 0x1300 }) );
+
+    // Nothing is read when the && is decided by its left side
+    addresses_read.clear();
+    const bool skipped = BreakpointCondition::Compile("0 && mem[$20]")->evaluate( registers, read_memory );
+
+    assert( !skipped );
+    assert( addresses_read.empty() );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running BreakpointConditionTests" << std::endl;
+
+    CompareRegisterAndMemory();
+    NumberFormats();
+    OperatorPrecedence();
+    LogicalOperatorsShortCircuit();
+    RegistersFlagsAndWords();
+    InvalidExpressionsAreReported();
+    OverflowWrapsAround();
+    DeepNestingIsRefused();
+    MemoryThroughADelegate();
+}
+
+}
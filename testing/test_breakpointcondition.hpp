@@ -0,0 +1,9 @@
+#ifndef TEST_BREAKPOINTCONDITION_HPP
+#define TEST_BREAKPOINTCONDITION_HPP
+
+namespace BreakpointConditionTests
+{
+void Run();
+}
+
+#endif // TEST_BREAKPOINTCONDITION_HPP
@@ -0,0 +1,237 @@
+#include "test_busdevice.hpp"
+#include "emulator/bus.hpp"
+#include "emulator/rambusdevice.hpp"
+#include <array>
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+namespace BusDeviceTests
+{
+
+/* A page of registers that counts the accesses made to it one at a time */
+class CountingDevice : public IBusDevice
+{
+public:
+    CountingDevice(addressType lower = 0xD000, addressType upper = 0xD0FF) : IBusDevice(lower, upper, true, true) {}
+
+    std::array<uint8_t, 256> registers{};
+    int reads = 0;
+    int writes = 0;
+
+protected:
+    void writeImplementation(addressType address, uint8_t data) override
+    {
+        registers[address & 0xFF] = data;
+        ++writes;
+    }
+
+    uint8_t readImplementation(addressType address, bool) override
+    {
+        ++reads;
+        return registers[address & 0xFF];
+    }
+};
+
+void RamBlocks()
+{
+    std::cout << "RamBlocks...";
+
+    RamBusDevice ram;
+    const std::vector<uint8_t> bytes{ 0x01, 0x02, 0x03, 0x04 };
+    std::array<uint8_t, 4> read_back{};
+
+    ram.collectChanges();
+    ram.writeBlock( 0x12FE, bytes.data(), bytes.size() );
+    ram.readBlock( 0x12FE, read_back.data(), read_back.size(), true );
+    assert( std::equal( bytes.begin(), bytes.end(), read_back.begin() ) );
+
+    // Both pages it spans are dirty, and no others
+    const uint64_t generation = ram.collectChanges();
+
+    assert( generation == 1 );
+    assert( ram.pageGenerations()[0x12] == 1 );
+    assert( ram.pageGenerations()[0x13] == 1 );
+    assert( !ram.changedSince( 0x0000, 0x11FF, 0 ) );
+    assert( !ram.changedSince( 0x1400, 0xFFFF, 0 ) );
+
+    ram.fill( 0x2000, 0x200, 0xEA );
+    assert( ram.memory()[0x2000] == 0xEA );
+    assert( ram.memory()[0x21FF] == 0xEA );
+    assert( ram.memory()[0x2200] == 0x00 );
+
+    // Overlapping copies come out as if through a buffer
+    ram.copy( 0x12FF, 0x12FE, 4 );
+    assert( ram.memory()[0x12FE] == 0x01 );
+    assert( ram.memory()[0x12FF] == 0x01 );
+    assert( ram.memory()[0x1300] == 0x02 );
+    assert( ram.memory()[0x1302] == 0x04 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void BlocksStopAtTheEndOfMemory()
+{
+    std::cout << "BlocksStopAtTheEndOfMemory...";
+
+    RamBusDevice ram;
+    const std::vector<uint8_t> bytes{ 0x01, 0x02, 0x03, 0x04 };
+    std::array<uint8_t, 4> read_back{ 0xFF, 0xFF, 0xFF, 0xFF };
+
+    ram.writeBlock( 0xFFFE, bytes.data(), bytes.size() );
+    assert( ram.memory()[0xFFFF] == 0x02 );
+    assert( ram.memory()[0x0000] == 0x00 );
+
+    ram.readBlock( 0xFFFE, read_back.data(), read_back.size(), true );
+    assert( (read_back == std::array<uint8_t, 4>{ 0x01, 0x02, 0x00, 0x00 }) );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void OtherDevicesGoAByteAtATime()
+{
+    std::cout << "OtherDevicesGoAByteAtATime...";
+
+    CountingDevice device;
+    std::vector<uint8_t> bytes( 0x20, 0x55 );
+
+    // Only the part in its range reaches it
+    device.writeBlock( 0xCFF0, bytes.data(), bytes.size() );
+    assert( device.writes == 0x10 );
+    assert( device.registers[0x0F] == 0x55 );
+    assert( device.registers[0x10] == 0x00 );
+
+    device.fill( 0xD0F8, 0x10, 0xAA );
+    assert( device.writes == 0x18 );
+    assert( device.registers[0xFF] == 0xAA );
+
+    std::vector<uint8_t> read_back( 0x20, 0xFF );
+
+    device.readBlock( 0xCFF0, read_back.data(), read_back.size(), false );
+    assert( device.reads == 0x10 );
+    assert( read_back[0x0F] == 0x00 );
+    assert( read_back[0x10] == 0x55 );
+
+    device.copy( 0xD080, 0xD000, 0x10 );
+    assert( device.registers[0x80] == 0x55 );
+    assert( device.reads == 0x20 );
+    assert( device.writes == 0x28 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void DevicesAreMappedOverRam()
+{
+    std::cout << "DevicesAreMappedOverRam...";
+
+    Bus bus;
+    RamBusDevice ram;
+    CountingDevice io;
+    CountingDevice registers( 0xD0F0, 0xD10F );
+    std::string error_message;
+
+    const bool ram_mapped = bus.map( &ram );
+    const bool io_mapped  = bus.map( &io, &error_message, &ram );
+
+    assert( ram_mapped );
+    assert( io_mapped );
+    assert( bus.deviceAt( 0xCFFF ) == &ram );
+    assert( bus.deviceAt( 0xD000 ) == &io );
+    assert( bus.deviceAt( 0xD0FF ) == &io );
+    assert( bus.deviceAt( 0xD100 ) == &ram );
+    assert( bus.mappedTo( 0x0000, 0xCFFF, &ram ) );
+    assert( !bus.mappedTo( 0xC000, 0xD000, &ram ) );
+
+    // Only RAM gives way
+    const bool overlapping_mapped = bus.map( &registers, &error_message, &ram );
+
+    assert( !overlapping_mapped );
+    assert( error_message == "$D0F0-$D10F overlaps the device at $D000-$D0FF from $D0F0" );
+    assert( bus.deviceAt( 0xD100 ) == &ram );
+
+    bus.write( 0xD010, 0x42 );
+    assert( io.registers[0x10] == 0x42 );
+    assert( ram.memory()[0xD010] == 0x00 );
+    assert( bus.read( 0xD010, false ) == 0x42 );
+
+    // RAM is back once the device is gone, with what it held before
+    ram.write( 0xD010, 0x99 );
+    bus.unmap( &io );
+    assert( bus.deviceAt( 0xD010 ) == &ram );
+    assert( bus.mappedTo( 0x0000, 0xFFFF, &ram ) );
+    assert( bus.read( 0xD010, false ) == 0x99 );
+
+    // Part of a page
+    const bool registers_mapped = bus.map( &registers, &error_message, &ram );
+
+    assert( registers_mapped );
+    assert( bus.deviceAt( 0xD0EF ) == &ram );
+    assert( bus.deviceAt( 0xD0F0 ) == &registers );
+    assert( bus.deviceAt( 0xD10F ) == &registers );
+    assert( bus.deviceAt( 0xD110 ) == &ram );
+
+    bus.unmap( &registers );
+    assert( bus.mappedTo( 0x0000, 0xFFFF, &ram ) );
+
+    // Nothing was underneath RAM
+    bus.unmap( &ram );
+    assert( bus.deviceAt( 0x1234 ) == nullptr );
+    assert( bus.read( 0x1234, false ) == 0x00 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void BlocksAreSplitBetweenDevices()
+{
+    std::cout << "BlocksAreSplitBetweenDevices...";
+
+    Bus bus;
+    RamBusDevice ram;
+    CountingDevice io( 0xD010, 0xD01F );
+    std::vector<uint8_t> bytes( 0x40, 0x55 );
+
+    bus.map( &ram );
+    bus.map( &io, nullptr, &ram );
+
+    bus.writeBlock( 0xD000, bytes.data(), bytes.size() );
+    assert( io.writes == 0x10 );
+    assert( ram.memory()[0xD00F] == 0x55 );
+    assert( ram.memory()[0xD010] == 0x00 );
+    assert( ram.memory()[0xD020] == 0x55 );
+
+    bus.fill( 0xD018, 0x10, 0xAA );
+    assert( io.registers[0x1F] == 0xAA );
+    assert( ram.memory()[0xD020] == 0xAA );
+    assert( ram.memory()[0xD028] == 0x55 );
+
+    std::vector<uint8_t> read_back( 0x40, 0xFF );
+
+    bus.readBlock( 0xD000, read_back.data(), read_back.size(), false );
+    assert( io.reads == 0x10 );
+    assert( read_back[0x00] == 0x55 );
+    assert( read_back[0x10] == 0x55 );
+    assert( read_back[0x1F] == 0xAA );
+    assert( read_back[0x20] == 0xAA );
+
+    // From the registers and the RAM after them
+    bus.copy( 0x0200, 0xD010, 0x20 );
+    assert( ram.memory()[0x0200] == 0x55 );
+    assert( ram.memory()[0x0208] == 0xAA );
+    assert( ram.memory()[0x0217] == 0xAA );
+    assert( ram.memory()[0x0218] == 0x55 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running BusDeviceTests" << std::endl;
+
+    RamBlocks();
+    BlocksStopAtTheEndOfMemory();
+    OtherDevicesGoAByteAtATime();
+    DevicesAreMappedOverRam();
+    BlocksAreSplitBetweenDevices();
+}
+
+}
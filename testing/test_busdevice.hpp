@@ -0,0 +1,9 @@
+#ifndef TEST_BUSDEVICE_HPP
+#define TEST_BUSDEVICE_HPP
+
+namespace BusDeviceTests
+{
+void Run();
+}
+
+#endif // TEST_BUSDEVICE_HPP
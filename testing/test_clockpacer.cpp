@@ -0,0 +1,104 @@
+#include "test_clockpacer.hpp"
+#include "clockpacer.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace ClockPacerTests
+{
+
+using namespace std::chrono_literals;
+
+void UnthrottledNeverWaits()
+{
+    std::cout << "UnthrottledNeverWaits...";
+
+    ClockPacer pacer;
+    const ClockPacer::clockType::time_point now{ 1s };
+
+    assert( !pacer.throttled() );
+    assert( pacer.sliceCycles( 10000 ) == 10000 );
+
+    const ClockPacer::clockType::time_point due = pacer.ran( 10000, now );
+
+    assert( due == now );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void SlicesFollowTheRate()
+{
+    std::cout << "SlicesFollowTheRate...";
+
+    ClockPacer pacer;
+
+    pacer.setRate( 1'023'000 );
+    assert( pacer.sliceCycles( 10000 ) == 1023 );
+    pacer.setRate( 200'000'000 );
+    assert( pacer.sliceCycles( 10000 ) == 10000 );
+    pacer.setRate( 100 );
+    assert( pacer.sliceCycles( 10000 ) == 1 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void DriftIsNotCumulative()
+{
+    std::cout << "DriftIsNotCumulative...";
+
+    ClockPacer pacer;
+    const ClockPacer::clockType::time_point start{ 1s };
+
+    pacer.setRate( 1'000'000 );
+    pacer.restart( start );
+
+    // Each slice finishing late still leaves the next one due on schedule
+    ClockPacer::clockType::time_point now = start;
+
+    for (int slice = 1; slice <= 2500; ++slice)
+    {
+        const ClockPacer::clockType::time_point due = pacer.ran( 1000, now );
+
+        assert( due == start + std::chrono::milliseconds( slice ) );
+        now = due + 20us;
+    }
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void FallingBehindStartsAfresh()
+{
+    std::cout << "FallingBehindStartsAfresh...";
+
+    ClockPacer pacer;
+    const ClockPacer::clockType::time_point start{ 1s };
+
+    pacer.setRate( 1'000'000 );
+    pacer.restart( start );
+
+    // Within the lag it catches up...
+    const ClockPacer::clockType::time_point caught_up = pacer.ran( 1000, start + 40ms );
+
+    assert( caught_up == start + 1ms );
+
+    // ...beyond it, it doesn't try to
+    const ClockPacer::clockType::time_point late      = start + 100ms;
+    const ClockPacer::clockType::time_point restarted = pacer.ran( 1000, late );
+    const ClockPacer::clockType::time_point next      = pacer.ran( 1000, late );
+
+    assert( restarted == late );
+    assert( next == late + 1ms );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running ClockPacerTests" << std::endl;
+
+    UnthrottledNeverWaits();
+    SlicesFollowTheRate();
+    DriftIsNotCumulative();
+    FallingBehindStartsAfresh();
+}
+
+}
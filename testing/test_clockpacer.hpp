@@ -0,0 +1,9 @@
+#ifndef TEST_CLOCKPACER_HPP
+#define TEST_CLOCKPACER_HPP
+
+namespace ClockPacerTests
+{
+void Run();
+}
+
+#endif // TEST_CLOCKPACER_HPP
@@ -0,0 +1,112 @@
+#include "test_directpages.hpp"
+#include "emulator/instructionexecutor.hpp"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <cassert>
+
+namespace DirectPagesTests
+{
+
+/* Memory reached through the delegates, remembering the lowest address they were called with */
+struct Machine
+{
+    std::array<uint8_t, 64 * 1024> memory{};
+    std::array<uint64_t, 4> dirty_pages{};
+    uint32_t lowest_access = 0x10000;
+    Registers registers;
+    InstructionExecutor executor{ registers,
+                                  [this](InstructionExecutor::addressType address, bool)
+                                  {
+                                      lowest_access = std::min<uint32_t>( lowest_access, address );
+                                      return memory[address];
+                                  },
+                                  [this](InstructionExecutor::addressType address, uint8_t data)
+                                  {
+                                      lowest_access = std::min<uint32_t>( lowest_access, address );
+                                      memory[address] = data;
+                                  },
+                                  [](uint8_t) {}, [](uint8_t) {}, [](uint8_t) {},
+                                  [](uint16_t) {},
+                                  [](uint8_t) {}, [](uint8_t) {} };
+
+    Machine()
+    {
+        /* $0200: LDX #$FF; TXS; LDA #$42; PHA; JSR $0220; PLA; STA $10; LDY #1; LDA ($20),Y; STA $11; JMP $0212
+           $0220: LDA #$00; STA $20; LDA #$03; STA $21; INC $10; RTS */
+        const uint8_t main[] = { 0xA2, 0xFF, 0x9A, 0xA9, 0x42, 0x48, 0x20, 0x20, 0x02, 0x68, 0x85, 0x10,
+                                 0xA0, 0x01, 0xB1, 0x20, 0x85, 0x11, 0x4C, 0x12, 0x02 };
+        const uint8_t subroutine[] = { 0xA9, 0x00, 0x85, 0x20, 0xA9, 0x03, 0x85, 0x21, 0xE6, 0x10, 0x60 };
+
+        std::copy( std::begin(main), std::end(main), memory.begin() + 0x0200 );
+        std::copy( std::begin(subroutine), std::end(subroutine), memory.begin() + 0x0220 );
+        memory[0x0301] = 0x77;
+        registers.program_counter = 0x0200;
+    }
+
+    void run(int instructions)
+    {
+        for ( ; instructions > 0; --instructions)
+        {
+            do
+                executor.clock();
+            while ( !executor.complete() );
+        }
+    }
+};
+
+void SameResultsWithoutTheDelegates()
+{
+    std::cout << "SameResultsWithoutTheDelegates...";
+
+    Machine through_delegates;
+    Machine direct;
+
+    direct.executor.setDirectPages( direct.memory.data(), &direct.dirty_pages[0] );
+    assert( direct.executor.directPages() );
+
+    through_delegates.run( 20 );
+    direct.run( 20 );
+
+    assert( through_delegates.memory[0x0010] == 0x42 );
+    assert( through_delegates.memory[0x0011] == 0x77 );
+    assert( through_delegates.lowest_access < 0x0200 );
+
+    assert( direct.memory == through_delegates.memory );
+    assert( direct.executor.stateHash() == through_delegates.executor.stateHash() );
+    assert( direct.executor.clock_ticks == through_delegates.executor.clock_ticks );
+
+    // Nothing in the zero page or the stack went through the delegates, but both pages were marked
+    assert( direct.lowest_access >= 0x0200 );
+    assert( direct.dirty_pages[0] == 0x03 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void TurnedOffAgain()
+{
+    std::cout << "TurnedOffAgain...";
+
+    Machine machine;
+
+    machine.executor.setDirectPages( machine.memory.data(), &machine.dirty_pages[0] );
+    machine.executor.setDirectPages( nullptr, nullptr );
+    assert( !machine.executor.directPages() );
+
+    machine.run( 20 );
+    assert( machine.memory[0x0011] == 0x77 );
+    assert( machine.lowest_access < 0x0200 );
+    assert( machine.dirty_pages[0] == 0 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running DirectPagesTests" << std::endl;
+
+    SameResultsWithoutTheDelegates();
+    TurnedOffAgain();
+}
+
+}
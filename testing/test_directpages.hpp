@@ -0,0 +1,9 @@
+#ifndef TEST_DIRECTPAGES_HPP
+#define TEST_DIRECTPAGES_HPP
+
+namespace DirectPagesTests
+{
+void Run();
+}
+
+#endif // TEST_DIRECTPAGES_HPP
@@ -0,0 +1,151 @@
+#include "test_lockstep.hpp"
+#include "emulator/lockstepchecker.hpp"
+#include <iostream>
+#include <memory>
+#include <cassert>
+
+namespace LockstepTests
+{
+
+/* A backend that goes wrong once it has executed a given number of instructions */
+class FaultyBackend : public ReferenceBackend
+{
+public:
+    enum Fault
+    {
+        WrongA,    ///< Flips a bit of A
+        ExtraWrite ///< Writes to $0010
+    };
+
+    explicit FaultyBackend(uint64_t faulty_instruction, Fault fault = WrongA)
+        :
+        _faulty_instruction( faulty_instruction ),
+        _fault( fault )
+    {
+    }
+
+    void setState(const CpuState &state) override
+    {
+        ReferenceBackend::setState( state );
+        _executed = 0;
+    }
+
+    void step() override
+    {
+        ReferenceBackend::step();
+        if ( _executed++ != _faulty_instruction )
+            return;
+
+        if ( _fault == WrongA )
+            _registers.a ^= 0x01;
+        else
+        {
+            _memory[0x0010] ^= 0x80;
+            _write_hash = HashWrite( _write_hash, 0x0010, _memory[0x0010] );
+        }
+    }
+
+protected:
+    uint64_t _faulty_instruction;
+    Fault    _fault;
+    uint64_t _executed = 0;
+};
+
+/* A loop that counts in memory: LDX #0; loop: INX; TXA; STA $0300,X; ADC $10; STA $10; JMP loop */
+static CpuState CountingLoop()
+{
+    CpuState state;
+    const uint8_t program[] = { 0xA2, 0x00, 0xE8, 0x8A, 0x9D, 0x00, 0x03, 0x65, 0x10, 0x85, 0x10, 0x4C, 0x02, 0x02 };
+
+    std::copy( std::begin(program), std::end(program), state.memory.begin() + 0x0200 );
+    state.registers.program_counter = 0x0200;
+    state.registers.stack_pointer = 0xFD;
+    state.write_hash = CpuBackend::InitialWriteHash;
+    return state;
+}
+
+void ReferenceAgreesWithItself()
+{
+    std::cout << "ReferenceAgreesWithItself...";
+
+    for (uint32_t interval : { 1u, 100u })
+    {
+        LockstepChecker checker( CpuBackend::Create("reference"), CpuBackend::Create("reference"), interval );
+
+        checker.start( CountingLoop() );
+        const bool agreed = checker.run( 10000 );
+
+        assert( agreed );
+        assert( !checker.divergence().has_value() );
+        assert( checker.instructions() > 2000 );
+        assert( checker.reference().writeHash() != CpuBackend::InitialWriteHash );
+    }
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void FindsTheInstructionThatDiverged()
+{
+    std::cout << "FindsTheInstructionThatDiverged...";
+
+    for (uint32_t interval : { 1u, 64u })
+    {
+        // Instruction 50 is the 9th time round the loop (after LDX), at its TXA
+        LockstepChecker checker( std::make_unique<ReferenceBackend>(), std::make_unique<FaultyBackend>( 50 ), interval );
+
+        checker.start( CountingLoop() );
+        const bool agreed = checker.run( 10000 );
+
+        assert( !agreed );
+        assert( checker.divergence().has_value() );
+        assert( checker.divergence()->instruction == 50 );
+        assert( checker.divergence()->address == 0x0203 );
+        assert( checker.divergence()->opcode == 0x8A );
+        assert( checker.divergence()->differences.find("a: reference") == 0 );
+    }
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void ReportsMemoryDifferences()
+{
+    std::cout << "ReportsMemoryDifferences...";
+
+    LockstepChecker checker( std::make_unique<ReferenceBackend>(), std::make_unique<FaultyBackend>( 3, FaultyBackend::ExtraWrite ), 16 );
+
+    checker.start( CountingLoop() );
+    const bool agreed = checker.run( 10000 );
+
+    assert( !agreed );
+    assert( checker.divergence()->instruction == 3 );
+    assert( checker.divergence()->differences.find("$0010: reference $") == 0 );
+
+    // It stays stopped until started again
+    const bool ran_again = checker.run( 10000 );
+
+    assert( !ran_again );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void UnknownBackendIsRejected()
+{
+    std::cout << "UnknownBackendIsRejected...";
+
+    assert( CpuBackend::Create("reference") != nullptr );
+    assert( CpuBackend::Create("no such backend") == nullptr );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running LockstepTests" << std::endl;
+
+    ReferenceAgreesWithItself();
+    FindsTheInstructionThatDiverged();
+    ReportsMemoryDifferences();
+    UnknownBackendIsRejected();
+}
+
+}
@@ -0,0 +1,9 @@
+#ifndef TEST_LOCKSTEP_HPP
+#define TEST_LOCKSTEP_HPP
+
+namespace LockstepTests
+{
+void Run();
+}
+
+#endif // TEST_LOCKSTEP_HPP
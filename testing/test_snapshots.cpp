@@ -0,0 +1,259 @@
+#include "test_snapshots.hpp"
+#include "emulator/machinesnapshot.hpp"
+#include "emulator/rambusdevice.hpp"
+#include "utilities/SpscQueue.hpp"
+#include <memory>
+#include <thread>
+#include <iostream>
+#include <cassert>
+
+namespace SnapshotTests
+{
+
+void OnlyNewSnapshotsAreTaken()
+{
+    std::cout << "OnlyNewSnapshotsAreTaken...";
+
+    auto buffer = std::make_unique<SnapshotBuffer>();
+    MachineSnapshot::memoryType memory{};
+    MachineSnapshot::pageGenerationsType generations{};
+
+    const bool acquired_before = buffer->acquire();
+
+    assert( !acquired_before );
+    assert( buffer->consumed() );
+
+    buffer->back().clock_ticks = 1;
+    buffer->publish( memory, generations, 1 );
+    assert( !buffer->consumed() );
+
+    // Publishing again before it is taken replaces it
+    buffer->back().clock_ticks = 2;
+    buffer->publish( memory, generations, 2 );
+
+    const bool acquired = buffer->acquire();
+
+    assert( acquired );
+    assert( buffer->consumed() );
+    assert( buffer->front().clock_ticks == 2 );
+    assert( buffer->front().generation == 2 );
+
+    const bool acquired_again = buffer->acquire();
+
+    assert( !acquired_again );
+    assert( buffer->front().clock_ticks == 2 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void ChangedPagesAreTracked()
+{
+    std::cout << "ChangedPagesAreTracked...";
+
+    auto buffer = std::make_unique<SnapshotBuffer>();
+    MachineSnapshot::memoryType memory{};
+    MachineSnapshot::pageGenerationsType generations{};
+    uint64_t generation = 1;
+
+    buffer->publish( memory, generations, generation );
+
+    const bool acquired = buffer->acquire();
+
+    assert( acquired );
+
+    const uint64_t first = buffer->front().generation;
+
+    // Each of these is published into a different one of the three snapshots,
+    // so every one of them has to catch up on the pages it missed
+    for (uint16_t address : { 0x0010, 0x1234, 0xFFFF, 0x1200 })
+    {
+        memory[address] = static_cast<uint8_t>(address) | 0x01;
+        generations[address >> 8] = ++generation;
+        buffer->publish( memory, generations, generation );
+
+        const bool acquired_change = buffer->acquire();
+
+        assert( acquired_change );
+        assert( buffer->front().memory == memory );
+    }
+
+    const MachineSnapshot &snapshot = buffer->front();
+
+    assert( snapshot.pageChangedSince( 0x00, first ) );
+    assert( snapshot.pageChangedSince( 0x12, first ) );
+    assert( snapshot.pageChangedSince( 0xFF, first ) );
+    assert( !snapshot.pageChangedSince( 0x01, first ) );
+    assert( !snapshot.pageChangedSince( 0x00, snapshot.generation - 1 ) );
+    assert( snapshot.pageChangedSince( 0x12, snapshot.generation - 1 ) );
+
+    assert( snapshot.changedSince( 0x1100, 0x1200, first ) );
+    assert( !snapshot.changedSince( 0x0100, 0x11FF, first ) );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void DirtyPagesAreCollected()
+{
+    std::cout << "DirtyPagesAreCollected...";
+
+    RamBusDevice ram;
+    const uint64_t unchanged = ram.collectChanges();
+
+    assert( unchanged == 0 );
+
+    // Nothing is seen until it is collected, and then it is all one generation
+    ram.write( 0x1234, 0x01 );
+    ram.write( 0x12FF, 0x02 );
+    ram.write( 0xFFFF, 0x03 );
+    assert( ram.generation() == 0 );
+    assert( !ram.changedSince( 0x0000, 0xFFFF, 0 ) );
+
+    const uint64_t written = ram.collectChanges();
+
+    assert( written == 1 );
+    assert( ram.pageGenerations()[0x12] == 1 );
+    assert( ram.pageGenerations()[0xFF] == 1 );
+    assert( ram.pageGenerations()[0x13] == 0 );
+    assert( ram.changedSince( 0x1100, 0x1200, 0 ) );
+    assert( !ram.changedSince( 0x1300, 0xFEFF, 0 ) );
+
+    // No writes, no new generation
+    const uint64_t not_written = ram.collectChanges();
+
+    assert( not_written == 1 );
+
+    ram.edit( 0x0040, 0x04 );
+
+    const uint64_t edited = ram.collectChanges();
+
+    assert( ram.memory()[0x0040] == 0x04 );
+    assert( edited == 2 );
+    assert( ram.pageGenerations()[0x00] == 2 );
+
+    // And a snapshot takes just the changed pages along with their generations
+    auto buffer = std::make_unique<SnapshotBuffer>();
+
+    buffer->publish( ram.memory(), ram.pageGenerations(), ram.generation() );
+
+    const bool acquired = buffer->acquire();
+
+    assert( acquired );
+    assert( buffer->front().memory == ram.memory() );
+    assert( buffer->front().page_generations == ram.pageGenerations() );
+    assert( buffer->front().generation == 2 );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void SnapshotsAreNeverTorn()
+{
+    std::cout << "SnapshotsAreNeverTorn...";
+
+    auto buffer = std::make_unique<SnapshotBuffer>();
+    constexpr uint64_t Snapshots = 2000;
+
+    std::thread producer( [&buffer]()
+    {
+        auto memory = std::make_unique<MachineSnapshot::memoryType>();
+        MachineSnapshot::pageGenerationsType generations{};
+
+        for (uint64_t count = 1; count <= Snapshots; ++count)
+        {
+            memory->fill( static_cast<uint8_t>(count) );
+            generations.fill( count );
+            buffer->back().clock_ticks = count;
+            buffer->publish( *memory, generations, count );
+        }
+    } );
+
+    uint64_t last = 0;
+
+    while ( last < Snapshots )
+    {
+        if ( !buffer->acquire() )
+            continue;
+
+        const MachineSnapshot &snapshot = buffer->front();
+
+        // Everything in a snapshot is from the same publish, and they only go forwards
+        assert( snapshot.clock_ticks > last );
+        assert( snapshot.memory.front() == static_cast<uint8_t>(snapshot.clock_ticks) );
+        assert( snapshot.memory.back() == static_cast<uint8_t>(snapshot.clock_ticks) );
+        last = snapshot.clock_ticks;
+    }
+    producer.join();
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void QueueKeepsOrder()
+{
+    std::cout << "QueueKeepsOrder...";
+
+    SpscQueue<int, 4> queue;
+
+    assert( queue.empty() );
+
+    const auto popped_empty = queue.pop();
+
+    assert( !popped_empty );
+    for (int value = 0; value < 4; ++value)
+    {
+        const bool pushed = queue.push( value );
+
+        assert( pushed );
+    }
+
+    const bool pushed_full = queue.push( 4 );
+    const auto popped      = queue.pop();
+    const bool pushed_more = queue.push( 4 );
+
+    assert( !pushed_full );
+    assert( popped == 0 );
+    assert( pushed_more );
+    for (int value = 1; value <= 4; ++value)
+    {
+        const auto popped_in_order = queue.pop();
+
+        assert( popped_in_order == value );
+    }
+    assert( queue.empty() );
+
+    // And across threads
+    SpscQueue<int, 16> shared;
+    constexpr int Items = 100000;
+
+    std::thread producer( [&shared]()
+    {
+        for (int value = 0; value < Items; )
+        {
+            if ( shared.push( value ) )
+                ++value;
+        }
+    } );
+
+    for (int expected = 0; expected < Items; )
+    {
+        if ( std::optional<int> value = shared.pop() )
+        {
+            assert( *value == expected );
+            ++expected;
+        }
+    }
+    producer.join();
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running SnapshotTests" << std::endl;
+
+    OnlyNewSnapshotsAreTaken();
+    ChangedPagesAreTracked();
+    DirtyPagesAreCollected();
+    SnapshotsAreNeverTorn();
+    QueueKeepsOrder();
+}
+
+}
@@ -0,0 +1,9 @@
+#ifndef TEST_SNAPSHOTS_HPP
+#define TEST_SNAPSHOTS_HPP
+
+namespace SnapshotTests
+{
+void Run();
+}
+
+#endif // TEST_SNAPSHOTS_HPP
@@ -0,0 +1,96 @@
+#include "test_statehash.hpp"
+#include "emulator/statehash.hpp"
+#include "emulator/computer.hpp"
+#include <array>
+#include <iostream>
+#include <cassert>
+
+namespace StateHashTests
+{
+
+void EveryByteCounts()
+{
+    std::cout << "EveryByteCounts...";
+
+    std::array<uint8_t, 64 * 1024> memory{};
+    const uint64_t zeroed = HashBytes( memory.data(), memory.size() );
+
+    assert( HashBytes( memory.data(), memory.size() ) == zeroed );
+
+    // The first byte, one in the middle of a block, and the odd bytes at the end
+    for (size_t address : { size_t{0}, size_t{0x1234}, memory.size() - 1 })
+    {
+        memory[address] = 1;
+        assert( HashBytes( memory.data(), memory.size() ) != zeroed );
+        memory[address] = 0;
+    }
+    assert( HashBytes( memory.data(), memory.size() - 1 ) != zeroed );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void SeedChangesTheHash()
+{
+    std::cout << "SeedChangesTheHash...";
+
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5 };
+
+    assert( HashBytes( bytes, sizeof(bytes), 1 ) != HashBytes( bytes, sizeof(bytes), 2 ) );
+    assert( HashCombine( 0, 1 ) != HashCombine( 0, 2 ) );
+    assert( HashCombine( HashCombine( 0, 1 ), 2 ) != HashCombine( HashCombine( 0, 2 ), 1 ) );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void SameRunSameHash()
+{
+    std::cout << "SameRunSameHash...";
+
+    // LDX #0; loop: INX; STX $10; JMP loop
+    const uint8_t program[] = { 0xA2, 0x00, 0xE8, 0x86, 0x10, 0x4C, 0x02, 0x02 };
+    const uint8_t reset_vector[] = { 0x00, 0x02 };
+    Computer first, second;
+
+    for (Computer *iCurrentComputer : { &first, &second })
+    {
+        iCurrentComputer->writeBlock( 0x0200, program, sizeof(program) );
+        iCurrentComputer->writeBlock( olc6502::ResetJumpStartAddress, reset_vector, sizeof(reset_vector) );
+        iCurrentComputer->cpu()->reset();
+        iCurrentComputer->stepInstruction( 100 );
+    }
+    assert( first.stateHash() == second.stateHash() );
+
+    // One instruction
+    first.stepInstruction();
+    assert( first.stateHash() != second.stateHash() );
+    second.stepInstruction();
+    assert( first.stateHash() == second.stateHash() );
+
+    // One byte of RAM, away from anything the program touches
+    const uint8_t changed = 0x5A;
+    const uint8_t restored = 0x00;
+
+    first.writeBlock( 0x3000, &changed, 1 );
+    assert( first.stateHash() != second.stateHash() );
+    first.writeBlock( 0x3000, &restored, 1 );
+    assert( first.stateHash() == second.stateHash() );
+
+    // One register
+    first.cpu()->registers().y ^= 0x01;
+    assert( first.stateHash() != second.stateHash() );
+    first.cpu()->registers().y ^= 0x01;
+    assert( first.stateHash() == second.stateHash() );
+
+    std::cout << "SUCCESS!" << std::endl;
+}
+
+void Run()
+{
+    std::cout << "Running StateHashTests" << std::endl;
+
+    EveryByteCounts();
+    SeedChangesTheHash();
+    SameRunSameHash();
+}
+
+}
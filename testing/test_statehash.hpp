@@ -0,0 +1,9 @@
+#ifndef TEST_STATEHASH_HPP
+#define TEST_STATEHASH_HPP
+
+namespace StateHashTests
+{
+void Run();
+}
+
+#endif // TEST_STATEHASH_HPP
@@ -13,10 +13,40 @@ INCLUDEPATH += $$APPDIR
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+        $$APPDIR/batchsizer.cpp \
+        $$APPDIR/clockpacer.cpp \
         $$APPDIR/utilities/StringConversions.cpp \
         $$APPDIR/io/SRecord/QSRecordStream.cpp \
         $$APPDIR/io/SRecord/srecord.cpp \
         $$APPDIR/io/SimpleHex/QSimpleHexStream.cpp \
+        $$APPDIR/io/io.cpp \
+        $$APPDIR/utilities/Profiling.cpp \
+        $$APPDIR/emulator/breakpointcondition.cpp \
+        $$APPDIR/emulator/breakpoints.cpp \
+        $$APPDIR/emulator/bus.cpp \
+        $$APPDIR/emulator/computer.cpp \
+        $$APPDIR/emulator/cpubackend.cpp \
+        $$APPDIR/emulator/flightrecorder.cpp \
+        $$APPDIR/emulator/ibusdevice.cpp \
+        $$APPDIR/emulator/instructionexecutor.cpp \
+        $$APPDIR/emulator/instructionprofile.cpp \
+        $$APPDIR/emulator/lockstepchecker.cpp \
+        $$APPDIR/emulator/machinesnapshot.cpp \
+        $$APPDIR/emulator/memoryheatmap.cpp \
+        $$APPDIR/emulator/olc6502.cpp \
+        $$APPDIR/emulator/rambusdevice.cpp \
+        $$APPDIR/emulator/sessionstatistics.cpp \
+        $$APPDIR/emulator/statehash.cpp \
+        $$APPDIR/emulator/usagemonitor.cpp \
+        $$APPDIR/emulator/writeprovenance.cpp \
+        test_batchsizer.cpp \
+        test_breakpointcondition.cpp \
+        test_busdevice.cpp \
+        test_clockpacer.cpp \
+        test_directpages.cpp \
+        test_lockstep.cpp \
+        test_snapshots.cpp \
+        test_statehash.cpp \
         test_simplehex.cpp \
         test_srecord.cpp \
         main.cpp
@@ -32,6 +62,27 @@ HEADERS += \
         $$APPDIR/io/SRecord/srecord.hpp \
         $$APPDIR/io/SRecord/QSRecordStream.hpp \
         $$APPDIR/io/SimpleHex/QSimpleHexStream.hpp \
+        $$APPDIR/batchsizer.hpp \
+        $$APPDIR/clockpacer.hpp \
+        $$APPDIR/emulator/breakpointcondition.hpp \
+        $$APPDIR/emulator/bus.hpp \
+        $$APPDIR/emulator/computer.hpp \
+        $$APPDIR/emulator/cpubackend.hpp \
+        $$APPDIR/emulator/ibusdevice.hpp \
+        $$APPDIR/emulator/lockstepchecker.hpp \
+        $$APPDIR/emulator/machinesnapshot.hpp \
+        $$APPDIR/emulator/olc6502.hpp \
+        $$APPDIR/emulator/rambusdevice.hpp \
+        $$APPDIR/utilities/SpscQueue.hpp \
+        $$APPDIR/emulator/statehash.hpp \
+        test_batchsizer.hpp \
+        test_breakpointcondition.hpp \
+        test_busdevice.hpp \
+        test_clockpacer.hpp \
+        test_directpages.hpp \
+        test_lockstep.hpp \
+        test_snapshots.hpp \
+        test_statehash.hpp \
         test_simplehex.hpp \
         test_srecord.hpp
 